@@ -0,0 +1,121 @@
+"""
+Runtime API of the usdFbx plugin.
+
+USD only loads the plugin library on the first Fbx open, importing this module loads it right away and exposes the
+functions it exports with C linkage (see src/CApi.h).
+
+Example:
+    import usdFbx
+    usdFbx.Prewarm()
+"""
+import ctypes
+import os
+
+from pxr import Plug
+
+PLUGIN_NAME = "usdFbx"
+
+
+def _load_library():
+    plugin = Plug.Registry().GetPluginWithName(PLUGIN_NAME)
+    if plugin is None:
+        raise ImportError(f"The {PLUGIN_NAME} plugin was not found, check PXR_PLUGINPATH_NAME")
+    # Loading through Plug runs the registry functions of the library, ctypes then gets the same handle
+    if not plugin.Load():
+        raise ImportError(f"Unable to load the {PLUGIN_NAME} plugin from {plugin.path}")
+    library = ctypes.CDLL(plugin.path)
+
+    library.UsdFbxPrewarm.argtypes = []
+    library.UsdFbxPrewarm.restype = None
+    library.UsdFbxWaitForPrewarm.argtypes = [ctypes.c_double]
+    library.UsdFbxWaitForPrewarm.restype = ctypes.c_bool
+    library.UsdFbxPrewarmAssets.argtypes = [
+        ctypes.POINTER(ctypes.c_char_p),
+        ctypes.c_size_t,
+        ctypes.POINTER(ctypes.c_char_p),
+        ctypes.POINTER(ctypes.c_char_p),
+        ctypes.c_size_t,
+        ctypes.c_size_t,
+    ]
+    library.UsdFbxPrewarmAssets.restype = None
+    library.UsdFbxWaitForPrewarmedAssets.argtypes = [ctypes.c_double]
+    library.UsdFbxWaitForPrewarmedAssets.restype = ctypes.c_bool
+    library.UsdFbxGetPrewarmedAssetCount.argtypes = []
+    library.UsdFbxGetPrewarmedAssetCount.restype = ctypes.c_size_t
+    library.UsdFbxClearPrewarmedAssets.argtypes = []
+    library.UsdFbxClearPrewarmedAssets.restype = None
+    library.UsdFbxCancelOpen.argtypes = [ctypes.c_char_p]
+    library.UsdFbxCancelOpen.restype = ctypes.c_bool
+    library.UsdFbxCancelAllOpens.argtypes = []
+    library.UsdFbxCancelAllOpens.restype = None
+    return library
+
+
+_library = _load_library()
+
+
+def _timeout_seconds(timeout):
+    return -1.0 if timeout is None else max(0.0, float(timeout))
+
+
+def _string_array(strings):
+    return (ctypes.c_char_p * len(strings))(*strings)
+
+
+def Prewarm():
+    """Starts warming up the Fbx SDK on a background thread, opens that start before it is done wait for it."""
+    _library.UsdFbxPrewarm()
+
+
+def WaitForPrewarm(timeout=None):
+    """
+    Waits at most timeout seconds, forever when None, for the warm-up to finish.
+    Returns False when the warm-up was never started or is still running.
+    """
+    return _library.UsdFbxWaitForPrewarm(_timeout_seconds(timeout))
+
+
+def PrewarmAssets(file_paths, args=None, max_threads=0):
+    """
+    Converts Fbx files into memory on background threads, using at most max_threads threads (0 for one per core).
+    The layers opened afterwards for the same files and file format arguments are served without converting them,
+    converted files that no layer opens are dropped after USDFBX_PREWARM_EXPIRY seconds (600 by default).
+    """
+    paths = [os.fsencode(os.fspath(path)) for path in file_paths]
+    args = args or {}
+    names = [str(name).encode() for name in args]
+    values = [str(value).encode() for value in args.values()]
+    _library.UsdFbxPrewarmAssets(
+        _string_array(paths), len(paths), _string_array(names), _string_array(values), len(args), max_threads
+    )
+
+
+def WaitForPrewarmedAssets(timeout=None):
+    """
+    Waits at most timeout seconds, forever when None, for the files given to PrewarmAssets to be converted.
+    Returns False when some are still being converted.
+    """
+    return _library.UsdFbxWaitForPrewarmedAssets(_timeout_seconds(timeout))
+
+
+def GetPrewarmedAssetCount():
+    """Returns the number of prewarmed files that no layer has opened yet."""
+    return _library.UsdFbxGetPrewarmedAssetCount()
+
+
+def ClearPrewarmedAssets():
+    """Drops the prewarmed files that no layer has opened yet."""
+    _library.UsdFbxClearPrewarmedAssets()
+
+
+def CancelOpen(file_path):
+    """
+    Cancels the opens of file_path that are running or waiting on the Fbx SDK, which then fail or keep a partial
+    layer depending on their onCancel argument. Returns False when no open of that file was found.
+    """
+    return _library.UsdFbxCancelOpen(os.fsencode(os.fspath(file_path)))
+
+
+def CancelAllOpens():
+    """Cancels every open that is running or waiting on the Fbx SDK."""
+    _library.UsdFbxCancelAllOpens()
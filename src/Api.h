@@ -0,0 +1,11 @@
+// Copyright (C) Remedy Entertainment Plc.
+
+#pragma once
+
+#include <pxr/base/arch/export.h>
+
+#if defined( USDFBX_EXPORTS )
+#define USDFBX_API ARCH_EXPORT
+#else
+#define USDFBX_API ARCH_IMPORT
+#endif
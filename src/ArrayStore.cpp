@@ -0,0 +1,201 @@
+// Copyright (C) Remedy Entertainment Plc.
+
+#include "ArrayStore.h"
+
+#include "PrecompiledHeader.h"
+
+#include <pxr/base/arch/hash.h>
+#include <pxr/base/gf/half.h>
+#include <pxr/base/gf/matrix4d.h>
+#include <pxr/base/gf/quatf.h>
+#include <pxr/base/gf/quath.h>
+#include <pxr/base/gf/vec2f.h>
+#include <pxr/base/gf/vec2h.h>
+#include <pxr/base/gf/vec3d.h>
+#include <pxr/base/gf/vec3f.h>
+#include <pxr/base/gf/vec3h.h>
+#include <pxr/base/gf/vec4f.h>
+#include <pxr/base/tf/envSetting.h>
+#include <pxr/base/trace/trace.h>
+#include <pxr/base/vt/array.h>
+
+#include <cstring>
+#include <vector>
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+TF_DEFINE_ENV_SETTING( USDFBX_SHARE_ARRAYS, false, "Share identical large arrays between all the Fbx layers of the process" );
+
+namespace
+{
+	// Below this size the bookkeeping costs more than what sharing could save
+	constexpr size_t MIN_SHARED_BYTES = 16 * 1024;
+} // namespace
+
+/// Owns a shared buffer. VtArrays reference it as their foreign data source,
+/// the store is told when the last of them lets go.
+///
+/// VtArray drops its reference before it calls back into the store, so an entry
+/// whose count reached zero may still be in use by that callback. Such an entry
+/// is never handed out again: exactly one callback follows the last reference,
+/// and it is the only one that frees the entry.
+class remedy::ArrayStore::Entry : public Vt_ArrayForeignDataSource
+{
+public:
+	explicit Entry( uint64_t hash )
+		: Vt_ArrayForeignDataSource( &Entry::detached )
+		, m_hash( hash )
+	{
+	}
+
+	virtual ~Entry() = default;
+
+	uint64_t GetHash() const
+	{
+		return m_hash;
+	}
+
+	/// Takes a reference for a new VtArray, unless the last one is already gone.
+	bool TryAcquire()
+	{
+		size_t count = _refCount.load();
+		while( count > 0 )
+		{
+			if( _refCount.compare_exchange_weak( count, count + 1 ) )
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+private:
+	static void detached( Vt_ArrayForeignDataSource* self )
+	{
+		ArrayStore::GetInstance().release( static_cast< Entry* >( self ) );
+	}
+
+	uint64_t m_hash;
+};
+
+namespace
+{
+	template< typename T >
+	class TypedEntry : public remedy::ArrayStore::Entry
+	{
+	public:
+		TypedEntry( uint64_t hash, const VtArray< T >& array )
+			: Entry( hash )
+			, data( array.cbegin(), array.cend() )
+		{
+		}
+
+		std::vector< T > data;
+	};
+} // namespace
+
+remedy::ArrayStore& remedy::ArrayStore::GetInstance()
+{
+	// Never destroyed, layers released during shutdown still report back to it
+	static ArrayStore* instance = new ArrayStore();
+	return *instance;
+}
+
+bool remedy::ArrayStore::IsEnabled()
+{
+	return TfGetEnvSetting( USDFBX_SHARE_ARRAYS );
+}
+
+size_t remedy::ArrayStore::GetSize() const
+{
+	std::lock_guard lock( m_mutex );
+	return m_entries.size();
+}
+
+template< typename T >
+bool remedy::ArrayStore::share( VtValue& value )
+{
+	// Only instantiated for plain data types, which are hashed and compared byte for byte
+	if( !value.IsHolding< VtArray< T > >() )
+	{
+		return false;
+	}
+
+	const auto& array = value.UncheckedGet< VtArray< T > >();
+	const size_t byteCount = array.size() * sizeof( T );
+	if( byteCount < MIN_SHARED_BYTES )
+	{
+		return true;
+	}
+
+	const uint64_t hash = ArchHash64( reinterpret_cast< const char* >( array.cdata() ), byteCount );
+
+	// The shared array replaces value once the lock is released, as dropping the
+	// previous array can release an entry and call back into the store
+	VtArray< T > shared;
+	{
+		std::lock_guard lock( m_mutex );
+		const auto [ begin, end ] = m_hashes.equal_range( hash );
+		for( auto it = begin; it != end; ++it )
+		{
+			auto* entry = dynamic_cast< TypedEntry< T >* >( it->second );
+			if( entry != nullptr && entry->data.size() == array.size()
+				&& std::memcmp( entry->data.data(), array.cdata(), byteCount ) == 0 && entry->TryAcquire() )
+			{
+				// The reference taken by TryAcquire goes to the array
+				shared = VtArray< T >( entry, entry->data.data(), entry->data.size(), false );
+				break;
+			}
+		}
+
+		if( shared.empty() )
+		{
+			auto entry = std::make_unique< TypedEntry< T > >( hash, array );
+			shared = VtArray< T >( entry.get(), entry->data.data(), entry->data.size() );
+			m_hashes.emplace( hash, entry.get() );
+			m_entries.emplace( entry.get(), std::move( entry ) );
+		}
+	}
+
+	value = VtValue::Take( shared );
+	return true;
+}
+
+void remedy::ArrayStore::Share( VtValue& value )
+{
+	if( !value.IsArrayValued() )
+	{
+		return;
+	}
+
+	TRACE_FUNCTION()
+	share< GfVec3f >( value ) || share< GfVec2f >( value ) || share< GfVec3h >( value ) || share< GfVec2h >( value )
+		|| share< GfVec4f >( value ) || share< GfVec3d >( value ) || share< GfQuatf >( value ) || share< GfQuath >( value )
+		|| share< GfMatrix4d >( value ) || share< int >( value ) || share< float >( value ) || share< double >( value )
+		|| share< GfHalf >( value ) || share< unsigned char >( value );
+}
+
+void remedy::ArrayStore::release( Entry* entry )
+{
+	std::unique_ptr< Entry > released;
+	{
+		std::lock_guard lock( m_mutex );
+		const auto it = m_entries.find( entry );
+		if( !TF_VERIFY( it != m_entries.end() ) )
+		{
+			return;
+		}
+
+		const auto [ begin, end ] = m_hashes.equal_range( entry->GetHash() );
+		for( auto hashIt = begin; hashIt != end; ++hashIt )
+		{
+			if( hashIt->second == entry )
+			{
+				m_hashes.erase( hashIt );
+				break;
+			}
+		}
+		released = std::move( it->second );
+		m_entries.erase( it );
+	}
+}
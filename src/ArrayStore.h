@@ -0,0 +1,64 @@
+// Copyright (C) Remedy Entertainment Plc.
+
+#pragma once
+
+#include <pxr/base/vt/value.h>
+#include <pxr/pxr.h>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+namespace remedy
+{
+	/// \class ArrayStore
+	///
+	/// Process-wide, content addressed store for the large arrays of converted
+	/// layers. Identical meshes, skin weights or rest poses found in several Fbx
+	/// files (LODs, variants, shots) end up sharing a single buffer.
+	///
+	/// The store only holds weak references: a shared buffer is released as soon
+	/// as the last VtArray using it is destroyed or written to, since writing to
+	/// a VtArray always detaches it from a shared buffer first.
+	///
+	/// Sharing hashes and copies every large array of every opened layer, which only
+	/// pays off when many layers hold the same data. It is off by default and turned
+	/// on with USDFBX_SHARE_ARRAYS=1.
+	class ArrayStore
+	{
+	public:
+		static ArrayStore& GetInstance();
+
+		/// Returns false when sharing is disabled by the environment.
+		static bool IsEnabled();
+
+		/// Replaces the array held by \p value with an identical array backed by a
+		/// shared buffer. Values that do not hold an array of plain data, or whose
+		/// array is smaller than the sharing threshold, are left untouched.
+		void Share( VtValue& value );
+
+		/// Returns the number of buffers currently shared.
+		size_t GetSize() const;
+
+		ArrayStore( const ArrayStore& ) = delete;
+		void operator=( const ArrayStore& ) = delete;
+
+		class Entry;
+
+	private:
+		ArrayStore() = default;
+
+		template< typename T >
+		bool share( VtValue& value );
+
+		// Called once no VtArray references entry any more
+		void release( Entry* entry );
+
+		mutable std::mutex m_mutex;
+		std::unordered_map< const Entry*, std::unique_ptr< Entry > > m_entries;
+		std::unordered_multimap< uint64_t, Entry* > m_hashes;
+	};
+} // namespace remedy
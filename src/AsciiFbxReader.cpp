@@ -0,0 +1,778 @@
+// Copyright (C) Remedy Entertainment Plc.
+
+#include "AsciiFbxReader.h"
+
+#include "DebugCodes.h"
+#include "PrecompiledHeader.h"
+
+#include <pxr/base/arch/fileSystem.h>
+#include <pxr/base/tf/fileUtils.h>
+#include <pxr/base/tf/stringUtils.h>
+#include <pxr/base/trace/trace.h>
+#include <pxr/base/work/loops.h>
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string_view>
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+namespace
+{
+	using Geometry = remedy::AsciiFbxReader::Geometry;
+	using LayerElement = remedy::AsciiFbxReader::LayerElement;
+
+	constexpr size_t npos = std::string_view::npos;
+
+	// Number arrays with more text than this are split and parsed on several threads
+	constexpr size_t PARALLEL_CHUNK_SIZE = 1 << 18;
+
+	// Geometries are renamed to this prefix followed by their ordinal in the
+	// stripped copy, which is how Apply() finds them back after the import
+	constexpr std::string_view GEOMETRY_MARKER = "usdFbxAscii_";
+
+	// The stripped copy is only worth writing when the arrays cut out of it make
+	// up at least this much of the file, smaller files are left to the SDK
+	constexpr double MIN_STRIPPED_FRACTION = 0.5;
+
+	// Every ASCII Fbx file written by the SDK starts with this comment. Older
+	// versions lay out arrays differently and are left to the SDK.
+	constexpr std::string_view ASCII_FBX_7_HEADER = "; FBX 7";
+
+	/// A "Name: values" line, optionally followed by a { body }.
+	struct Element
+	{
+		std::string_view name;
+		std::string_view values;
+		size_t begin = 0;
+		size_t end = 0;
+		size_t bodyBegin = npos;
+		size_t bodyEnd = npos;
+	};
+
+	/// Replaces [begin, end) of the original file in the stripped copy.
+	struct Edit
+	{
+		size_t begin;
+		size_t end;
+		std::string replacement;
+	};
+
+	std::string_view trim( std::string_view str )
+	{
+		const size_t first = str.find_first_not_of( " \t\r\n" );
+		if( first == npos )
+		{
+			return {};
+		}
+		return str.substr( first, str.find_last_not_of( " \t\r\n" ) - first + 1 );
+	}
+
+	// Returns the position right after the '}' closing the block whose content
+	// starts at pos, or npos when the file is malformed.
+	size_t skipBlock( std::string_view text, size_t pos )
+	{
+		int depth = 1;
+		while( pos < text.size() )
+		{
+			switch( text[ pos ] )
+			{
+			case '"':
+				pos = text.find( '"', pos + 1 );
+				if( pos == npos )
+				{
+					return npos;
+				}
+				++pos;
+				break;
+			case ';':
+				pos = text.find( '\n', pos );
+				break;
+			case '{':
+				++depth;
+				++pos;
+				break;
+			case '}':
+				if( --depth == 0 )
+				{
+					return pos + 1;
+				}
+				++pos;
+				break;
+			case '*':
+			{
+				// Number arrays ("*12 { a: 0,1,... }") hold neither strings nor nested
+				// blocks, their content is skipped in one go
+				const size_t digitsEnd = text.find_first_not_of( "0123456789", pos + 1 );
+				const size_t brace = text.find_first_not_of( " \t", digitsEnd );
+				if( digitsEnd != pos + 1 && brace != npos && text[ brace ] == '{' )
+				{
+					pos = text.find( '}', brace );
+					if( pos == npos )
+					{
+						return npos;
+					}
+				}
+				++pos;
+				break;
+			}
+			default:
+				++pos;
+			}
+		}
+		return npos;
+	}
+
+	// Calls fn for every element in [pos, end). Returns false when the text is
+	// malformed or fn returned false.
+	template< typename Fn >
+	bool forEachElement( std::string_view text, size_t pos, size_t end, Fn&& fn )
+	{
+		while( true )
+		{
+			pos = text.find_first_not_of( " \t\r\n", pos );
+			if( pos == npos || pos >= end )
+			{
+				return true;
+			}
+			if( text[ pos ] == ';' )
+			{
+				pos = text.find( '\n', pos );
+				continue;
+			}
+
+			const size_t colon = text.find( ':', pos );
+			if( colon == npos || colon >= end )
+			{
+				return false;
+			}
+
+			Element element;
+			element.name = text.substr( pos, colon - pos );
+			element.begin = pos;
+
+			size_t valuesEnd = colon + 1;
+			char last = ':';
+			while( valuesEnd < end && text[ valuesEnd ] != '{' )
+			{
+				const char c = text[ valuesEnd ];
+				if( c == '"' )
+				{
+					valuesEnd = text.find( '"', valuesEnd + 1 );
+					if( valuesEnd == npos || valuesEnd >= end )
+					{
+						return false;
+					}
+					last = c;
+					++valuesEnd;
+					continue;
+				}
+				// Values continue on the next line after a trailing comma
+				if( c == '\n' && last != ',' )
+				{
+					break;
+				}
+				if( c != ' ' && c != '\t' && c != '\r' && c != '\n' )
+				{
+					last = c;
+				}
+				++valuesEnd;
+			}
+			element.values = trim( text.substr( colon + 1, valuesEnd - colon - 1 ) );
+
+			if( valuesEnd < end && text[ valuesEnd ] == '{' )
+			{
+				const size_t close = skipBlock( text, valuesEnd + 1 );
+				if( close == npos || close > end )
+				{
+					return false;
+				}
+				element.bodyBegin = valuesEnd + 1;
+				element.bodyEnd = close - 1;
+				element.end = close;
+			}
+			else
+			{
+				element.end = valuesEnd;
+			}
+
+			if( !fn( element ) )
+			{
+				return false;
+			}
+			pos = element.end;
+		}
+	}
+
+	bool isSeparator( char c )
+	{
+		return c == ',' || c == ' ' || c == '\t' || c == '\r' || c == '\n';
+	}
+
+	bool isNumberChar( char c )
+	{
+		return ( c >= '0' && c <= '9' ) || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+	}
+
+	bool parseValue( const char* first, const char* last, int& value )
+	{
+		const auto [ ptr, error ] = std::from_chars( first, last, value );
+		return error == std::errc() && ptr == last;
+	}
+
+	// The floating point std::from_chars is missing from older libc++ releases
+	// and std::strtod depends on the locale, TfStringToDouble is neither
+	bool parseValue( const char* first, const char* last, double& value )
+	{
+		if( first == last || !std::all_of( first, last, isNumberChar ) )
+		{
+			return false;
+		}
+		value = TfStringToDouble( first, static_cast< int >( last - first ) );
+		return true;
+	}
+
+	template< typename T >
+	bool parseNumbers( const char* first, const char* last, std::vector< T >& out )
+	{
+		while( true )
+		{
+			first = std::find_if_not( first, last, isSeparator );
+			if( first == last )
+			{
+				return true;
+			}
+
+			const char* valueEnd = std::find_if( first, last, isSeparator );
+			T value;
+			if( !parseValue( first, valueEnd, value ) )
+			{
+				return false;
+			}
+			out.push_back( value );
+			first = valueEnd;
+		}
+	}
+
+	// Parses a "Name: *count { a: ... }" element. Large arrays are cut into chunks
+	// at value separators and the chunks are parsed in parallel.
+	template< typename T >
+	bool parseArray( std::string_view text, const Element& element, std::vector< T >& out )
+	{
+		size_t count = 0;
+		if( element.bodyBegin == npos || element.values.size() < 2 || element.values[ 0 ] != '*'
+			|| std::from_chars( element.values.data() + 1, element.values.data() + element.values.size(), count ).ec
+				   != std::errc() )
+		{
+			return false;
+		}
+
+		std::string_view body = text.substr( element.bodyBegin, element.bodyEnd - element.bodyBegin );
+		const size_t prefix = body.find( "a:" );
+		if( prefix == npos )
+		{
+			return count == 0;
+		}
+		body.remove_prefix( prefix + 2 );
+
+		out.clear();
+		out.reserve( count );
+		if( body.size() <= PARALLEL_CHUNK_SIZE )
+		{
+			return parseNumbers( body.data(), body.data() + body.size(), out ) && out.size() == count;
+		}
+
+		std::vector< size_t > bounds{ 0 };
+		while( body.size() - bounds.back() > PARALLEL_CHUNK_SIZE )
+		{
+			const size_t next = body.find( ',', bounds.back() + PARALLEL_CHUNK_SIZE );
+			if( next == npos )
+			{
+				break;
+			}
+			bounds.push_back( next );
+		}
+		bounds.push_back( body.size() );
+
+		std::vector< std::vector< T > > chunks( bounds.size() - 1 );
+		std::atomic< bool > failed = false;
+		WorkParallelForN(
+			chunks.size(),
+			[ & ]( size_t begin, size_t end )
+			{
+				for( size_t i = begin; i < end; ++i )
+				{
+					chunks[ i ].reserve( count / chunks.size() + 1 );
+					if( !parseNumbers( body.data() + bounds[ i ], body.data() + bounds[ i + 1 ], chunks[ i ] ) )
+					{
+						failed = true;
+					}
+				}
+			} );
+		if( failed )
+		{
+			return false;
+		}
+
+		for( const auto& chunk : chunks )
+		{
+			out.insert( out.end(), chunk.begin(), chunk.end() );
+		}
+		return out.size() == count;
+	}
+
+	// Pulls the arrays out of a Geometry: id, "Geometry::name", "Mesh" { ... }
+	// object, recording the edits that cut them out of the stripped copy.
+	bool parseGeometry(
+		std::string_view text,
+		const Element& object,
+		size_t ordinal,
+		Geometry& geometry,
+		std::vector< Edit >& edits,
+		const remedy::CancelToken& cancelToken )
+	{
+		const size_t nameBegin = object.values.find( '"' );
+		const size_t nameEnd = nameBegin == npos ? npos : object.values.find( '"', nameBegin + 1 );
+		if( nameEnd == npos )
+		{
+			return false;
+		}
+		const std::string_view name = object.values.substr( nameBegin + 1, nameEnd - nameBegin - 1 );
+		const size_t separator = name.find( "::" );
+		geometry.name = std::string( separator == npos ? name : name.substr( separator + 2 ) );
+
+		const size_t valuesOffset = static_cast< size_t >( object.values.data() - text.data() );
+		edits.push_back( { valuesOffset + nameBegin + 1,
+						   valuesOffset + nameEnd,
+						   TfStringPrintf( "Geometry::%s%zu", std::string( GEOMETRY_MARKER ).c_str(), ordinal ) } );
+
+		const auto strip = [ & ]( const Element& element ) { edits.push_back( { element.begin, element.end, {} } ); };
+
+		const auto parseLayerElement = [ & ](
+										   const Element& layerElement,
+										   std::string_view directName,
+										   std::string_view wName,
+										   std::string_view indexName,
+										   std::vector< LayerElement >& out )
+		{
+			LayerElement& result = out.emplace_back();
+			if( layerElement.bodyBegin == npos
+				|| std::from_chars(
+					   layerElement.values.data(),
+					   layerElement.values.data() + layerElement.values.size(),
+					   result.typedIndex )
+						   .ec
+					   != std::errc() )
+			{
+				return false;
+			}
+
+			return forEachElement(
+				text,
+				layerElement.bodyBegin,
+				layerElement.bodyEnd,
+				[ & ]( const Element& element )
+				{
+					if( element.name == directName )
+					{
+						strip( element );
+						return parseArray( text, element, result.direct );
+					}
+					if( !wName.empty() && element.name == wName )
+					{
+						strip( element );
+						return parseArray( text, element, result.w );
+					}
+					if( element.name == indexName )
+					{
+						strip( element );
+						return parseArray( text, element, result.index );
+					}
+					return true;
+				} );
+		};
+
+		return forEachElement(
+			text,
+			object.bodyBegin,
+			object.bodyEnd,
+			[ & ]( const Element& element )
+			{
+				if( cancelToken.IsCancelled() )
+				{
+					return false;
+				}
+				if( element.name == "Vertices" )
+				{
+					strip( element );
+					return parseArray( text, element, geometry.vertices );
+				}
+				if( element.name == "PolygonVertexIndex" )
+				{
+					strip( element );
+					return parseArray( text, element, geometry.polygonVertexIndex );
+				}
+				if( element.name == "Edges" )
+				{
+					// By-edge layer elements (smoothing, creases) follow the order of this
+					// array, which the SDK would not rebuild the same for every file
+					strip( element );
+					return parseArray( text, element, geometry.edges );
+				}
+				if( element.name == "LayerElementNormal" )
+				{
+					return parseLayerElement( element, "Normals", "NormalsW", "NormalsIndex", geometry.normals );
+				}
+				if( element.name == "LayerElementTangent" )
+				{
+					return parseLayerElement( element, "Tangents", "TangentsW", "TangentsIndex", geometry.tangents );
+				}
+				if( element.name == "LayerElementUV" )
+				{
+					return parseLayerElement( element, "UV", {}, "UVIndex", geometry.uvs );
+				}
+				if( element.name == "LayerElementColor" )
+				{
+					return parseLayerElement( element, "Colors", {}, "ColorIndex", geometry.colors );
+				}
+				return true;
+			} );
+	}
+
+	void copyIndices( FbxLayerElementArrayTemplate< int >& array, const std::vector< int >& indices )
+	{
+		array.Resize( static_cast< int >( indices.size() ) );
+		if( !indices.empty() )
+		{
+			int* data = array.GetLocked( FbxLayerElementArray::eWriteLock );
+			std::memcpy( data, indices.data(), indices.size() * sizeof( int ) );
+			array.Release( &data );
+		}
+	}
+
+	template< typename ElementT, typename MakeValueFn >
+	bool fillLayerElement( ElementT* element, const LayerElement& data, size_t stride, MakeValueFn&& makeValue )
+	{
+		if( element == nullptr || data.direct.size() % stride != 0 )
+		{
+			return false;
+		}
+
+		const size_t count = data.direct.size() / stride;
+		if( !data.w.empty() && data.w.size() != count )
+		{
+			return false;
+		}
+
+		// SetAt locks and unlocks the array on every call, write through one lock instead
+		auto& direct = element->GetDirectArray();
+		direct.Resize( static_cast< int >( count ) );
+		auto* values = direct.GetLocked( FbxLayerElementArray::eWriteLock );
+		for( size_t i = 0; i < count; ++i )
+		{
+			values[ i ] = makeValue( &data.direct[ i * stride ], data.w.empty() ? 1.0 : data.w[ i ] );
+		}
+		direct.Release( &values );
+
+		if( !data.index.empty() )
+		{
+			copyIndices( element->GetIndexArray(), data.index );
+		}
+		return true;
+	}
+
+	bool applyGeometry( FbxMesh* mesh, const Geometry& geometry )
+	{
+		if( geometry.vertices.size() % 3 != 0 )
+		{
+			return false;
+		}
+
+		const int numPoints = static_cast< int >( geometry.vertices.size() / 3 );
+		mesh->InitControlPoints( numPoints );
+		FbxVector4* points = mesh->GetControlPoints();
+		for( int i = 0; i < numPoints; ++i )
+		{
+			points[ i ].Set( geometry.vertices[ i * 3 ], geometry.vertices[ i * 3 + 1 ], geometry.vertices[ i * 3 + 2 ] );
+		}
+
+		// Material indices were read by the SDK, keep them safe from BeginPolygon
+		std::vector< std::vector< int > > materialIndices;
+		for( int i = 0; i < mesh->GetElementMaterialCount(); ++i )
+		{
+			auto& indexArray = mesh->GetElementMaterial( i )->GetIndexArray();
+			auto& indices = materialIndices.emplace_back( indexArray.GetCount() );
+			if( !indices.empty() )
+			{
+				int* data = indexArray.GetLocked( FbxLayerElementArray::eReadLock );
+				std::memcpy( indices.data(), data, indices.size() * sizeof( int ) );
+				indexArray.Release( &data );
+			}
+		}
+
+		const auto numPolygons = std::count_if(
+			geometry.polygonVertexIndex.begin(),
+			geometry.polygonVertexIndex.end(),
+			[]( int index ) { return index < 0; } );
+		// BeginPolygon/AddPolygon is the only public way to build polygons, reserving keeps them from reallocating
+		mesh->ReservePolygonCount( static_cast< int >( numPolygons ) );
+		mesh->ReservePolygonVertexCount( static_cast< int >( geometry.polygonVertexIndex.size() ) );
+
+		bool inPolygon = false;
+		for( const int index : geometry.polygonVertexIndex )
+		{
+			if( !inPolygon )
+			{
+				mesh->BeginPolygon( -1, -1, -1, false );
+				inPolygon = true;
+			}
+
+			// The last vertex of every polygon is stored as -( index + 1 )
+			const int vertex = index < 0 ? -index - 1 : index;
+			if( vertex >= numPoints )
+			{
+				return false;
+			}
+			mesh->AddPolygon( vertex );
+
+			if( index < 0 )
+			{
+				mesh->EndPolygon();
+				inPolygon = false;
+			}
+		}
+		if( inPolygon )
+		{
+			return false;
+		}
+
+		for( int i = 0; i < mesh->GetElementMaterialCount(); ++i )
+		{
+			copyIndices( mesh->GetElementMaterial( i )->GetIndexArray(), materialIndices[ i ] );
+		}
+
+		// Edges are the polygon vertex indices they start from
+		const int numPolygonVertices = static_cast< int >( geometry.polygonVertexIndex.size() );
+		const auto isInvalidEdge = [ & ]( int edge ) { return edge < 0 || edge >= numPolygonVertices; };
+		if( std::any_of( geometry.edges.begin(), geometry.edges.end(), isInvalidEdge ) )
+		{
+			return false;
+		}
+		mesh->SetMeshEdgeCount( static_cast< int >( geometry.edges.size() ) );
+		for( size_t i = 0; i < geometry.edges.size(); ++i )
+		{
+			mesh->SetMeshEdge( static_cast< int >( i ), geometry.edges[ i ] );
+		}
+
+		const auto makeVector4 = []( const double* v, double w ) { return FbxVector4( v[ 0 ], v[ 1 ], v[ 2 ], w ); };
+		const auto makeVector2 = []( const double* v, double ) { return FbxVector2( v[ 0 ], v[ 1 ] ); };
+		const auto makeColor = []( const double* v, double ) { return FbxColor( v[ 0 ], v[ 1 ], v[ 2 ], v[ 3 ] ); };
+
+		for( const auto& normals : geometry.normals )
+		{
+			if( !fillLayerElement( mesh->GetElementNormal( normals.typedIndex ), normals, 3, makeVector4 ) )
+			{
+				return false;
+			}
+		}
+		for( const auto& tangents : geometry.tangents )
+		{
+			if( !fillLayerElement( mesh->GetElementTangent( tangents.typedIndex ), tangents, 3, makeVector4 ) )
+			{
+				return false;
+			}
+		}
+		for( const auto& uvs : geometry.uvs )
+		{
+			if( !fillLayerElement( mesh->GetElementUV( uvs.typedIndex ), uvs, 2, makeVector2 ) )
+			{
+				return false;
+			}
+		}
+		for( const auto& colors : geometry.colors )
+		{
+			if( !fillLayerElement( mesh->GetElementVertexColor( colors.typedIndex ), colors, 4, makeColor ) )
+			{
+				return false;
+			}
+		}
+
+		mesh->SetName( geometry.name.c_str() );
+		return true;
+	}
+} // namespace
+
+remedy::AsciiFbxReader::~AsciiFbxReader()
+{
+	if( !m_strippedFilePath.empty() )
+	{
+		TfDeleteFile( m_strippedFilePath );
+	}
+}
+
+bool remedy::AsciiFbxReader::IsAsciiFbx( const std::string& filePath )
+{
+	std::ifstream stream( filePath, std::ios::binary );
+	std::string header( ASCII_FBX_7_HEADER.size(), '\0' );
+	return stream.read( header.data(), static_cast< std::streamsize >( header.size() ) ) && header == ASCII_FBX_7_HEADER;
+}
+
+bool remedy::AsciiFbxReader::Parse( const std::string& filePath, const CancelToken& cancelToken )
+{
+	TRACE_FUNCTION()
+	std::string error;
+	const ArchConstFileMapping mapping = ArchMapFileReadOnly( filePath, &error );
+	if( !mapping )
+	{
+		TF_DEBUG( USDFBX ).Msg( "UsdFbx - Unable to map \"%s\": %s\n", filePath.c_str(), error.c_str() );
+		return false;
+	}
+
+	const std::string_view text( mapping.get(), ArchGetFileMappingLength( mapping ) );
+	if( text.substr( 0, ASCII_FBX_7_HEADER.size() ) != ASCII_FBX_7_HEADER )
+	{
+		return false;
+	}
+
+	// The top level objects are found serially, skipping over the content of the
+	// arrays, the mesh geometries are then parsed in parallel
+	std::vector< Element > meshes;
+	const bool scanned = forEachElement(
+		text,
+		0,
+		text.size(),
+		[ & ]( const Element& section )
+		{
+			if( section.name != "Objects" || section.bodyBegin == npos )
+			{
+				return true;
+			}
+			return forEachElement(
+				text,
+				section.bodyBegin,
+				section.bodyEnd,
+				[ & ]( const Element& object )
+				{
+					const bool isMesh = TfStringEndsWith( std::string( object.values ), "\"Mesh\"" );
+					if( object.name == "Geometry" && object.bodyBegin != npos && isMesh )
+					{
+						meshes.push_back( object );
+					}
+					return true;
+				} );
+		} );
+	if( !scanned || meshes.empty() )
+	{
+		return false;
+	}
+
+	m_geometries.resize( meshes.size() );
+	std::vector< std::vector< Edit > > geometryEdits( meshes.size() );
+	std::atomic< bool > failed = false;
+	WorkParallelForN(
+		meshes.size(),
+		[ & ]( size_t begin, size_t end )
+		{
+			for( size_t i = begin; i < end && !failed; ++i )
+			{
+				if( !parseGeometry( text, meshes[ i ], i, m_geometries[ i ], geometryEdits[ i ], cancelToken ) )
+				{
+					failed = true;
+				}
+			}
+		} );
+	if( failed )
+	{
+		TF_DEBUG( USDFBX ).Msg( "UsdFbx - \"%s\" can not take the ASCII fast path\n", filePath.c_str() );
+		m_geometries.clear();
+		return false;
+	}
+
+	std::vector< Edit > edits;
+	for( auto& geometryEdit : geometryEdits )
+	{
+		std::move( geometryEdit.begin(), geometryEdit.end(), std::back_inserter( edits ) );
+	}
+	std::sort( edits.begin(), edits.end(), []( const Edit& a, const Edit& b ) { return a.begin < b.begin; } );
+
+	size_t strippedSize = 0;
+	for( const auto& edit : edits )
+	{
+		strippedSize += edit.end - edit.begin - std::min( edit.end - edit.begin, edit.replacement.size() );
+	}
+	if( static_cast< double >( strippedSize ) < MIN_STRIPPED_FRACTION * static_cast< double >( text.size() ) )
+	{
+		TF_DEBUG( USDFBX ).Msg(
+			"UsdFbx - \"%s\" holds too little geometry for the ASCII fast path (%zu of %zu bytes)\n",
+			filePath.c_str(),
+			strippedSize,
+			text.size() );
+		m_geometries.clear();
+		return false;
+	}
+
+	m_strippedFilePath = ArchMakeTmpFileName( "usdFbxAscii", ".fbx" );
+	FILE* file = ArchOpenFile( m_strippedFilePath.c_str(), "wb" );
+	bool written = file != nullptr;
+	size_t pos = 0;
+	for( const auto& edit : edits )
+	{
+		written = written && fwrite( text.data() + pos, 1, edit.begin - pos, file ) == edit.begin - pos;
+		written = written && fwrite( edit.replacement.data(), 1, edit.replacement.size(), file ) == edit.replacement.size();
+		pos = edit.end;
+	}
+	written = written && fwrite( text.data() + pos, 1, text.size() - pos, file ) == text.size() - pos;
+	if( file != nullptr )
+	{
+		written = fclose( file ) == 0 && written;
+	}
+
+	if( !written )
+	{
+		TF_WARN(
+			"Unable to write \"%s\", importing \"%s\" without the ASCII fast path",
+			m_strippedFilePath.c_str(),
+			filePath.c_str() );
+		m_geometries.clear();
+		return false;
+	}
+
+	TF_DEBUG( USDFBX ).Msg( "UsdFbx - Parsed %zu meshes of \"%s\" ahead of the import\n", m_geometries.size(), filePath.c_str() );
+	return true;
+}
+
+bool remedy::AsciiFbxReader::Apply( FbxScene* scene ) const
+{
+	TRACE_FUNCTION()
+	std::vector< bool > applied( m_geometries.size(), false );
+	for( int i = 0, n = scene->GetSrcObjectCount< FbxMesh >(); i < n; ++i )
+	{
+		FbxMesh* mesh = scene->GetSrcObject< FbxMesh >( i );
+		const std::string_view name = mesh->GetName();
+		const size_t marker = name.find( GEOMETRY_MARKER );
+		if( marker == npos )
+		{
+			continue;
+		}
+
+		size_t ordinal = 0;
+		const char* first = name.data() + marker + GEOMETRY_MARKER.size();
+		const char* last = name.data() + name.size();
+		const auto [ ptr, error ] = std::from_chars( first, last, ordinal );
+		if( error != std::errc() || ptr != last || ordinal >= m_geometries.size() || applied[ ordinal ] )
+		{
+			return false;
+		}
+
+		if( !applyGeometry( mesh, m_geometries[ ordinal ] ) )
+		{
+			return false;
+		}
+		applied[ ordinal ] = true;
+	}
+	return std::all_of( applied.begin(), applied.end(), []( bool a ) { return a; } );
+}
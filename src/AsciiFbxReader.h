@@ -0,0 +1,82 @@
+// Copyright (C) Remedy Entertainment Plc.
+
+#pragma once
+
+#include "CancelToken.h"
+
+#include <fbxsdk.h>
+#include <string>
+#include <vector>
+
+namespace remedy
+{
+	/// \class AsciiFbxReader
+	///
+	/// Fast path for ASCII Fbx files, whose large number arrays the Fbx SDK
+	/// tokenizes one value at a time.
+	///
+	/// Parse() memory maps the file, splits the Objects section at its top level
+	/// objects and parses the geometry arrays of every mesh (points, polygon
+	/// vertex indices, normals, tangents, uvs and colors) on worker threads. The
+	/// arrays are cut out of a temporary copy of the file, which is what the Fbx
+	/// SDK imports instead of the original. Apply() then moves the parsed arrays
+	/// into the imported meshes, so the readers see the same scene as if the
+	/// original file had been imported. Files whose arrays are less than half of
+	/// their size are not worth the copy and are left to the SDK.
+	///
+	/// Parse() does not touch the Fbx SDK and can run without holding the SDK lock.
+	class AsciiFbxReader
+	{
+	public:
+		AsciiFbxReader() = default;
+		~AsciiFbxReader();
+
+		AsciiFbxReader( const AsciiFbxReader& ) = delete;
+		void operator=( const AsciiFbxReader& ) = delete;
+
+		/// Returns true when \p filePath is an ASCII Fbx 7.x file.
+		static bool IsAsciiFbx( const std::string& filePath );
+
+		/// Parses \p filePath and writes the stripped copy returned by
+		/// GetStrippedFilePath(). Returns false when the file can not take the fast
+		/// path, in which case it should be imported as is.
+		bool Parse( const std::string& filePath, const CancelToken& cancelToken );
+
+		/// The file to hand to the Fbx SDK after a successful Parse().
+		const std::string& GetStrippedFilePath() const
+		{
+			return m_strippedFilePath;
+		}
+
+		/// Fills the meshes of \p scene, imported from GetStrippedFilePath(), with
+		/// the parsed arrays. Returns false when the scene does not match what was
+		/// parsed, in which case the original file should be imported instead.
+		bool Apply( FbxScene* scene ) const;
+
+		/// Arrays of a LayerElementNormal/Tangent/UV/Color block.
+		struct LayerElement
+		{
+			int typedIndex = 0;
+			std::vector< double > direct;
+			std::vector< double > w;
+			std::vector< int > index;
+		};
+
+		/// Arrays of a "Mesh" Geometry object, as laid out in the file.
+		struct Geometry
+		{
+			std::string name;
+			std::vector< double > vertices;
+			std::vector< int > polygonVertexIndex;
+			std::vector< int > edges;
+			std::vector< LayerElement > normals;
+			std::vector< LayerElement > tangents;
+			std::vector< LayerElement > uvs;
+			std::vector< LayerElement > colors;
+		};
+
+	private:
+		std::vector< Geometry > m_geometries;
+		std::string m_strippedFilePath;
+	};
+} // namespace remedy
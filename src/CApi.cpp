@@ -0,0 +1,104 @@
+// Copyright (C) Remedy Entertainment Plc.
+
+#include "CApi.h"
+
+#include "CancelToken.h"
+#include "FbxGlobals.h"
+#include "PrecompiledHeader.h"
+#include "UsdFbxLayerCache.h"
+
+#include <chrono>
+#include <future>
+#include <optional>
+#include <string>
+#include <vector>
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	bool waitUntil( const std::shared_future< void >& future, const std::optional< Clock::time_point >& deadline )
+	{
+		if( !future.valid() )
+		{
+			return false;
+		}
+		if( !deadline )
+		{
+			future.wait();
+			return true;
+		}
+		return future.wait_until( *deadline ) == std::future_status::ready;
+	}
+
+	std::optional< Clock::time_point > getDeadline( double timeoutSeconds )
+	{
+		if( timeoutSeconds < 0.0 )
+		{
+			return std::nullopt;
+		}
+		return Clock::now() + std::chrono::duration_cast< Clock::duration >( std::chrono::duration< double >( timeoutSeconds ) );
+	}
+} // namespace
+
+void UsdFbxPrewarm()
+{
+	remedy::Prewarm();
+}
+
+bool UsdFbxWaitForPrewarm( double timeoutSeconds )
+{
+	return waitUntil( remedy::FbxGlobals::getInstance().getPrewarm(), getDeadline( timeoutSeconds ) );
+}
+
+void UsdFbxPrewarmAssets(
+	const char* const* filePaths,
+	size_t fileCount,
+	const char* const* argNames,
+	const char* const* argValues,
+	size_t argCount,
+	size_t maxThreads )
+{
+	const std::vector< std::string > files( filePaths, filePaths + fileCount );
+	SdfFileFormat::FileFormatArguments args;
+	for( size_t i = 0; i < argCount; ++i )
+	{
+		args[ argNames[ i ] ] = argValues[ i ];
+	}
+	remedy::PrewarmAssets( files, args, maxThreads );
+}
+
+bool UsdFbxWaitForPrewarmedAssets( double timeoutSeconds )
+{
+	const auto deadline = getDeadline( timeoutSeconds );
+	for( const auto& batch : remedy::UsdFbxLayerCache::GetInstance().GetPendingBatches() )
+	{
+		if( !waitUntil( batch, deadline ) )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+size_t UsdFbxGetPrewarmedAssetCount()
+{
+	return remedy::UsdFbxLayerCache::GetInstance().GetSize();
+}
+
+void UsdFbxClearPrewarmedAssets()
+{
+	remedy::UsdFbxLayerCache::GetInstance().Clear();
+}
+
+bool UsdFbxCancelOpen( const char* filePath )
+{
+	return remedy::CancelOpen( filePath );
+}
+
+void UsdFbxCancelAllOpens()
+{
+	remedy::CancelAllOpens();
+}
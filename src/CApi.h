@@ -0,0 +1,50 @@
+// Copyright (C) Remedy Entertainment Plc.
+
+#pragma once
+
+#include "Api.h"
+
+#include <cstddef>
+
+/// Entry points of the plugin library with C linkage.
+///
+/// The plugin is a module that installs no headers, these are what hosts reach
+/// once the library is loaded. The usdFbx Python module (python/usdFbx) calls
+/// them through ctypes.
+extern "C"
+{
+	/// Starts warming up the Fbx SDK on a background thread, see remedy::Prewarm().
+	USDFBX_API void UsdFbxPrewarm();
+
+	/// Waits at most \p timeoutSeconds for the warm-up to finish, forever when
+	/// negative. Returns false when the warm-up was never started or is still running.
+	USDFBX_API bool UsdFbxWaitForPrewarm( double timeoutSeconds );
+
+	/// Converts \p fileCount files into the in-process layer cache on background
+	/// threads, see remedy::PrewarmAssets(). \p argNames and \p argValues hold
+	/// \p argCount file format arguments used for the conversions.
+	USDFBX_API void UsdFbxPrewarmAssets(
+		const char* const* filePaths,
+		size_t fileCount,
+		const char* const* argNames,
+		const char* const* argValues,
+		size_t argCount,
+		size_t maxThreads );
+
+	/// Waits at most \p timeoutSeconds for every conversion started by
+	/// UsdFbxPrewarmAssets() to finish, forever when negative.
+	USDFBX_API bool UsdFbxWaitForPrewarmedAssets( double timeoutSeconds );
+
+	/// Returns the number of prewarmed files that no layer has opened yet.
+	USDFBX_API size_t UsdFbxGetPrewarmedAssetCount();
+
+	/// Drops the prewarmed files that no layer has opened yet.
+	USDFBX_API void UsdFbxClearPrewarmedAssets();
+
+	/// Cancels the opens of \p filePath, see remedy::CancelOpen(). Returns false
+	/// when no such open was found.
+	USDFBX_API bool UsdFbxCancelOpen( const char* filePath );
+
+	/// Cancels every running open, see remedy::CancelAllOpens().
+	USDFBX_API void UsdFbxCancelAllOpens();
+}
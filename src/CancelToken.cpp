@@ -0,0 +1,84 @@
+// Copyright (C) Remedy Entertainment Plc.
+
+#include "CancelToken.h"
+
+#include "DebugCodes.h"
+#include "PrecompiledHeader.h"
+
+#include <pxr/base/tf/pathUtils.h>
+
+#include <map>
+#include <mutex>
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+namespace
+{
+	struct ActiveOpens
+	{
+		std::mutex mutex;
+		std::multimap< std::string, remedy::CancelToken* > tokens;
+	};
+
+	ActiveOpens& getActiveOpens()
+	{
+		static ActiveOpens activeOpens;
+		return activeOpens;
+	}
+
+	std::string makeKey( const std::string& filePath )
+	{
+		return TfNormPath( TfAbsPath( filePath ) );
+	}
+} // namespace
+
+remedy::ScopedCancelRegistration::ScopedCancelRegistration( const std::string& filePath, CancelToken& token )
+	: m_key( makeKey( filePath ) )
+	, m_token( token )
+{
+	auto& activeOpens = getActiveOpens();
+	std::lock_guard lock( activeOpens.mutex );
+	activeOpens.tokens.emplace( m_key, &m_token );
+}
+
+remedy::ScopedCancelRegistration::~ScopedCancelRegistration()
+{
+	auto& activeOpens = getActiveOpens();
+	std::lock_guard lock( activeOpens.mutex );
+	auto [ begin, end ] = activeOpens.tokens.equal_range( m_key );
+	for( auto it = begin; it != end; ++it )
+	{
+		if( it->second == &m_token )
+		{
+			activeOpens.tokens.erase( it );
+			break;
+		}
+	}
+}
+
+bool remedy::CancelOpen( const std::string& filePath )
+{
+	auto& activeOpens = getActiveOpens();
+	std::lock_guard lock( activeOpens.mutex );
+	auto [ begin, end ] = activeOpens.tokens.equal_range( makeKey( filePath ) );
+	for( auto it = begin; it != end; ++it )
+	{
+		it->second->Cancel();
+	}
+	TF_DEBUG( USDFBX ).Msg(
+		"UsdFbx - Cancelled %zu open(s) of \"%s\"\n",
+		static_cast< size_t >( std::distance( begin, end ) ),
+		filePath.c_str() );
+	return begin != end;
+}
+
+void remedy::CancelAllOpens()
+{
+	auto& activeOpens = getActiveOpens();
+	std::lock_guard lock( activeOpens.mutex );
+	for( auto& [ key, token ] : activeOpens.tokens )
+	{
+		token->Cancel();
+	}
+	TF_DEBUG( USDFBX ).Msg( "UsdFbx - Cancelled %zu open(s)\n", activeOpens.tokens.size() );
+}
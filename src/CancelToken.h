@@ -0,0 +1,104 @@
+// Copyright (C) Remedy Entertainment Plc.
+
+#pragma once
+
+#include "Api.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace remedy
+{
+	/// Cooperative cancellation flag for a single UsdFbxDataReader::Open.
+	///
+	/// The reader polls IsCancelled() at its checkpoints (per node, per reader and
+	/// per sampled frame). A token is cancelled either explicitly through Cancel(),
+	/// CancelOpen() or CancelAllOpens(), or implicitly once its deadline has passed
+	/// or its checkpoint budget is spent.
+	class CancelToken
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		CancelToken() = default;
+
+		CancelToken( const CancelToken& ) = delete;
+		void operator=( const CancelToken& ) = delete;
+
+		/// Cancels the token once \p seconds have elapsed from now.
+		void SetTimeout( double seconds )
+		{
+			m_deadline
+				= Clock::now() + std::chrono::duration_cast< Clock::duration >( std::chrono::duration< double >( seconds ) );
+		}
+
+		/// Cancels the token once IsCancelled() has been called \p checkpoints more times, 0 disables it.
+		void SetCheckpointBudget( int64_t checkpoints )
+		{
+			m_checkpoints = checkpoints;
+		}
+
+		void Cancel()
+		{
+			m_cancelled = true;
+		}
+
+		[[nodiscard]] bool IsCancelled() const
+		{
+			if( !m_cancelled && m_deadline && Clock::now() >= *m_deadline )
+			{
+				m_cancelled = true;
+				m_timedOut = true;
+			}
+			if( !m_cancelled && m_checkpoints > 0 && m_checkpoints.fetch_sub( 1 ) == 1 )
+			{
+				m_cancelled = true;
+			}
+			return m_cancelled;
+		}
+
+		/// Returns true when a checkpoint has observed the cancellation, without
+		/// evaluating the deadline again.
+		[[nodiscard]] bool WasCancelled() const
+		{
+			return m_cancelled;
+		}
+
+		/// Returns true when the token was cancelled by its deadline rather than explicitly.
+		[[nodiscard]] bool HasTimedOut() const
+		{
+			return m_timedOut;
+		}
+
+	private:
+		mutable std::atomic< bool > m_cancelled = false;
+		mutable std::atomic< bool > m_timedOut = false;
+		mutable std::atomic< int64_t > m_checkpoints = 0;
+		std::optional< Clock::time_point > m_deadline;
+	};
+
+	/// Makes \p token reachable through CancelOpen( \p filePath ) for the lifetime of this object.
+	class ScopedCancelRegistration
+	{
+	public:
+		ScopedCancelRegistration( const std::string& filePath, CancelToken& token );
+		~ScopedCancelRegistration();
+
+		ScopedCancelRegistration( const ScopedCancelRegistration& ) = delete;
+		void operator=( const ScopedCancelRegistration& ) = delete;
+
+	private:
+		std::string m_key;
+		CancelToken& m_token;
+	};
+
+	/// Cancels every open of \p filePath that is currently running or waiting on the
+	/// Fbx SDK. Returns false when no such open was found.
+	USDFBX_API bool CancelOpen( const std::string& filePath );
+
+	/// Cancels every Fbx open currently running or waiting on the Fbx SDK.
+	USDFBX_API void CancelAllOpens();
+} // namespace remedy
@@ -0,0 +1,418 @@
+// Copyright (C) Remedy Entertainment Plc.
+
+#include "CompressedFbxStream.h"
+
+#include "DebugCodes.h"
+#include "PrecompiledHeader.h"
+
+#include <pxr/base/arch/fileSystem.h>
+#include <pxr/base/tf/fileUtils.h>
+#include <pxr/base/tf/pathUtils.h>
+#include <pxr/base/tf/stringUtils.h>
+#include <pxr/base/trace/trace.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <string_view>
+#ifdef USDFBX_HAS_ZLIB
+#include <zlib.h>
+#endif
+#ifdef USDFBX_HAS_ZSTD
+#include <zstd.h>
+#endif
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+namespace
+{
+	constexpr std::string_view BINARY_FBX_HEADER = "Kaydara FBX Binary";
+	constexpr size_t INPUT_CHUNK_SIZE = 1 << 20;
+	constexpr size_t OUTPUT_CHUNK_SIZE = 4 << 20;
+} // namespace
+
+/// Decompresses a file one chunk at a time.
+class remedy::CompressedFbxStream::Decompressor
+{
+public:
+	explicit Decompressor( const std::string& filePath )
+		: m_file( ArchOpenFile( filePath.c_str(), "rb" ) )
+		, m_input( INPUT_CHUNK_SIZE )
+	{
+	}
+
+	virtual ~Decompressor()
+	{
+		if( m_file != nullptr )
+		{
+			fclose( m_file );
+		}
+	}
+
+	/// Decompresses at most capacity bytes into output. Returns the number of
+	/// bytes written, 0 once the file has been fully decompressed or on error.
+	/// A file that ends in the middle of a compressed stream is an error.
+	virtual size_t Decompress( char* output, size_t capacity ) = 0;
+
+	bool HasFailed() const
+	{
+		return m_failed;
+	}
+
+protected:
+	// Refills m_input once everything read so far has been consumed
+	bool readInput()
+	{
+		if( m_inputPos < m_inputSize )
+		{
+			return true;
+		}
+		m_inputPos = 0;
+		m_inputSize = m_file != nullptr ? fread( m_input.data(), 1, m_input.size(), m_file ) : 0;
+		return m_inputSize > 0;
+	}
+
+	FILE* m_file;
+	std::vector< char > m_input;
+	size_t m_inputPos = 0;
+	size_t m_inputSize = 0;
+	bool m_failed = false;
+};
+
+namespace
+{
+#ifdef USDFBX_HAS_ZLIB
+	class GzipDecompressor : public remedy::CompressedFbxStream::Decompressor
+	{
+	public:
+		explicit GzipDecompressor( const std::string& filePath )
+			: Decompressor( filePath )
+		{
+			// 32 lets zlib detect the gzip or zlib header, 15 is the largest window size
+			m_failed = m_file == nullptr || inflateInit2( &m_stream, 15 + 32 ) != Z_OK;
+		}
+
+		~GzipDecompressor() override
+		{
+			inflateEnd( &m_stream );
+		}
+
+		size_t Decompress( char* output, size_t capacity ) override
+		{
+			m_stream.next_out = reinterpret_cast< Bytef* >( output );
+			m_stream.avail_out = static_cast< uInt >( std::min< size_t >( capacity, std::numeric_limits< uInt >::max() ) );
+			while( !m_failed && m_stream.avail_out > 0 )
+			{
+				// Past the end of the file, zlib may still hold output it could not write yet
+				const bool hasInput = readInput();
+				m_stream.next_in = reinterpret_cast< Bytef* >( m_input.data() + m_inputPos );
+				m_stream.avail_in = static_cast< uInt >( m_inputSize - m_inputPos );
+				const int result = inflate( &m_stream, Z_NO_FLUSH );
+				m_inputPos = m_inputSize - m_stream.avail_in;
+				if( result == Z_STREAM_END )
+				{
+					// Concatenated gzip members decompress as a single file
+					inflateReset( &m_stream );
+					m_inMember = false;
+				}
+				else if( result == Z_BUF_ERROR && !hasInput )
+				{
+					if( m_inMember )
+					{
+						TF_DEBUG( USDFBX ).Msg( "UsdFbx - The gzip file is truncated\n" );
+						m_failed = true;
+					}
+					break;
+				}
+				else if( result != Z_OK )
+				{
+					TF_DEBUG( USDFBX ).Msg( "UsdFbx - zlib failed to inflate: %s\n", m_stream.msg ? m_stream.msg : "" );
+					m_failed = true;
+				}
+				else
+				{
+					m_inMember = true;
+				}
+			}
+			return m_failed ? 0 : capacity - m_stream.avail_out;
+		}
+
+	private:
+		z_stream m_stream = {};
+		// Whether the last member read has not reached its end yet
+		bool m_inMember = false;
+	};
+#endif
+
+#ifdef USDFBX_HAS_ZSTD
+	class ZstdDecompressor : public remedy::CompressedFbxStream::Decompressor
+	{
+	public:
+		explicit ZstdDecompressor( const std::string& filePath )
+			: Decompressor( filePath )
+			, m_stream( ZSTD_createDStream() )
+		{
+			m_failed = m_file == nullptr || m_stream == nullptr || ZSTD_isError( ZSTD_initDStream( m_stream ) );
+		}
+
+		~ZstdDecompressor() override
+		{
+			ZSTD_freeDStream( m_stream );
+		}
+
+		size_t Decompress( char* output, size_t capacity ) override
+		{
+			ZSTD_outBuffer out = { output, capacity, 0 };
+			while( !m_failed && out.pos < out.size )
+			{
+				// Past the end of the file, zstd may still hold output it could not write yet
+				const bool hasInput = readInput();
+				ZSTD_inBuffer in = { m_input.data(), m_inputSize, m_inputPos };
+				const size_t outputPos = out.pos;
+				const size_t result = ZSTD_decompressStream( m_stream, &out, &in );
+				const bool progressed = in.pos != m_inputPos || out.pos != outputPos;
+				m_inputPos = in.pos;
+				if( ZSTD_isError( result ) )
+				{
+					TF_DEBUG( USDFBX ).Msg( "UsdFbx - zstd failed to decompress: %s\n", ZSTD_getErrorName( result ) );
+					m_failed = true;
+				}
+				else if( progressed )
+				{
+					// 0 once a frame is fully decoded and flushed
+					m_inFrame = result != 0;
+				}
+				else if( !hasInput )
+				{
+					if( m_inFrame )
+					{
+						TF_DEBUG( USDFBX ).Msg( "UsdFbx - The zstd file is truncated\n" );
+						m_failed = true;
+					}
+					break;
+				}
+			}
+			return m_failed ? 0 : out.pos;
+		}
+
+	private:
+		ZSTD_DStream* m_stream;
+		// Whether the last frame read has not reached its end yet
+		bool m_inFrame = false;
+	};
+#endif
+} // namespace
+
+remedy::FbxCompression remedy::GetFbxCompression( const std::string& filePath )
+{
+	if( TfStringToLower( TfGetExtension( TfStringGetBeforeSuffix( filePath ) ) ) != "fbx" )
+	{
+		return FbxCompression::None;
+	}
+
+	const std::string extension = TfStringToLower( TfGetExtension( filePath ) );
+	if( extension == "gz" )
+	{
+		return FbxCompression::Gzip;
+	}
+	if( extension == "zst" )
+	{
+		return FbxCompression::Zstd;
+	}
+	return FbxCompression::None;
+}
+
+bool remedy::IsFbxCompressionSupported( FbxCompression compression )
+{
+	switch( compression )
+	{
+	case FbxCompression::Gzip:
+#ifdef USDFBX_HAS_ZLIB
+		return true;
+#else
+		return false;
+#endif
+	case FbxCompression::Zstd:
+#ifdef USDFBX_HAS_ZSTD
+		return true;
+#else
+		return false;
+#endif
+	default:
+		return false;
+	}
+}
+
+remedy::CompressedFbxStream::CompressedFbxStream( const std::string& filePath, FbxCompression compression )
+{
+	switch( compression )
+	{
+#ifdef USDFBX_HAS_ZLIB
+	case FbxCompression::Gzip:
+		m_decompressor = std::make_unique< GzipDecompressor >( filePath );
+		break;
+#endif
+#ifdef USDFBX_HAS_ZSTD
+	case FbxCompression::Zstd:
+		m_decompressor = std::make_unique< ZstdDecompressor >( filePath );
+		break;
+#endif
+	default:
+		break;
+	}
+	m_error = !m_decompressor || m_decompressor->HasFailed();
+	m_complete = m_error;
+}
+
+remedy::CompressedFbxStream::~CompressedFbxStream()
+{
+	if( !m_spoolPath.empty() )
+	{
+		TfDeleteFile( m_spoolPath );
+	}
+}
+
+void remedy::CompressedFbxStream::decompressUpTo( size_t size ) const
+{
+	TRACE_FUNCTION()
+	while( m_data.size() < size && !m_complete )
+	{
+		const size_t offset = m_data.size();
+		m_data.resize( offset + OUTPUT_CHUNK_SIZE );
+		const size_t decompressed = m_decompressor->Decompress( m_data.data() + offset, OUTPUT_CHUNK_SIZE );
+		m_data.resize( offset + decompressed );
+		m_complete = decompressed == 0;
+		m_error = m_error || m_decompressor->HasFailed();
+	}
+}
+
+bool remedy::CompressedFbxStream::HasFailed() const
+{
+	return !m_decompressor || m_decompressor->HasFailed();
+}
+
+bool remedy::CompressedFbxStream::IsBinaryFbx() const
+{
+	decompressUpTo( BINARY_FBX_HEADER.size() );
+	return m_data.size() >= BINARY_FBX_HEADER.size()
+		   && std::string_view( m_data.data(), BINARY_FBX_HEADER.size() ) == BINARY_FBX_HEADER;
+}
+
+std::string remedy::CompressedFbxStream::Spool( const CancelToken& cancelToken )
+{
+	TRACE_FUNCTION()
+	m_spoolPath = ArchMakeTmpFileName( "usdFbxSpool", ".fbx" );
+	FILE* file = ArchOpenFile( m_spoolPath.c_str(), "wb" );
+	bool written = file != nullptr && fwrite( m_data.data(), 1, m_data.size(), file ) == m_data.size();
+
+	// What has not been decompressed yet goes straight to the file, through a
+	// single chunk instead of the in-memory copy used for streaming
+	std::vector< char > chunk( m_complete ? 0 : OUTPUT_CHUNK_SIZE );
+	while( written && !m_complete && !cancelToken.IsCancelled() )
+	{
+		const size_t decompressed = m_decompressor->Decompress( chunk.data(), chunk.size() );
+		written = fwrite( chunk.data(), 1, decompressed, file ) == decompressed;
+		m_complete = decompressed == 0;
+	}
+	m_error = m_error || m_decompressor->HasFailed();
+	if( file != nullptr )
+	{
+		written = fclose( file ) == 0 && written;
+	}
+
+	if( !written || m_error || !m_complete )
+	{
+		return {};
+	}
+	return m_spoolPath;
+}
+
+FbxStream::EState remedy::CompressedFbxStream::GetState()
+{
+	return m_state;
+}
+
+bool remedy::CompressedFbxStream::Open( void* )
+{
+	// Opening again, e.g. for a second import, reuses what has been decompressed
+	m_position = 0;
+	m_state = m_error ? eClosed : eOpen;
+	return !m_error;
+}
+
+bool remedy::CompressedFbxStream::Close()
+{
+	m_state = eClosed;
+	return true;
+}
+
+bool remedy::CompressedFbxStream::Flush()
+{
+	return true;
+}
+
+size_t remedy::CompressedFbxStream::Write( const void*, FbxUInt64 )
+{
+	// Read only
+	return 0;
+}
+
+size_t remedy::CompressedFbxStream::Read( void* data, FbxUInt64 size ) const
+{
+	decompressUpTo( m_position + static_cast< size_t >( size ) );
+	const size_t read = std::min( static_cast< size_t >( size ), m_data.size() - std::min( m_position, m_data.size() ) );
+	if( read > 0 )
+	{
+		std::memcpy( data, m_data.data() + m_position, read );
+	}
+	m_position += read;
+	return read;
+}
+
+int remedy::CompressedFbxStream::GetReaderID() const
+{
+	return m_readerId;
+}
+
+int remedy::CompressedFbxStream::GetWriterID() const
+{
+	return -1;
+}
+
+void remedy::CompressedFbxStream::Seek( const FbxInt64& offset, const FbxFile::ESeekPos& seekPos )
+{
+	FbxInt64 position = offset;
+	if( seekPos == FbxFile::eCurrent )
+	{
+		position += static_cast< FbxInt64 >( m_position );
+	}
+	else if( seekPos == FbxFile::eEnd )
+	{
+		// The end is only known once everything has been inflated
+		decompressUpTo( std::numeric_limits< size_t >::max() );
+		position += static_cast< FbxInt64 >( m_data.size() );
+	}
+	SetPosition( position );
+}
+
+FbxInt64 remedy::CompressedFbxStream::GetPosition() const
+{
+	return static_cast< FbxInt64 >( m_position );
+}
+
+void remedy::CompressedFbxStream::SetPosition( FbxInt64 position )
+{
+	// Seeking past the end is allowed, the next Read() then returns nothing
+	m_position = static_cast< size_t >( std::max< FbxInt64 >( position, 0 ) );
+}
+
+int remedy::CompressedFbxStream::GetError() const
+{
+	return m_error ? 1 : 0;
+}
+
+void remedy::CompressedFbxStream::ClearError()
+{
+	m_error = false;
+}
@@ -0,0 +1,93 @@
+// Copyright (C) Remedy Entertainment Plc.
+
+#pragma once
+
+#include "CancelToken.h"
+
+#include <fbxsdk.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace remedy
+{
+	enum class FbxCompression
+	{
+		None,
+		Gzip,
+		Zstd
+	};
+
+	/// Returns the compression of \p filePath based on its extension, e.g.
+	/// Gzip for "asset.fbx.gz". Files that are not Fbx files return None.
+	FbxCompression GetFbxCompression( const std::string& filePath );
+
+	/// Returns true when this build of the plugin can decompress \p compression.
+	bool IsFbxCompressionSupported( FbxCompression compression );
+
+	/// \class CompressedFbxStream
+	///
+	/// FbxStream over a compressed Fbx file. This is a full in-memory inflate: the
+	/// file is decompressed into memory as the importer reads or seeks past what
+	/// has been decompressed so far, and everything decompressed is kept until the
+	/// stream is destroyed, since the importer seeks back into what it already read.
+	/// Seeking relative to the end inflates the whole file at once. Importing a
+	/// compressed file therefore costs as much memory as its uncompressed size, in
+	/// exchange no uncompressed copy is ever written to disk.
+	///
+	/// The Fbx SDK only imports binary Fbx files from streams. Compressed ASCII
+	/// files have to be spooled to disk with Spool() and imported from there.
+	class CompressedFbxStream : public FbxStream
+	{
+	public:
+		CompressedFbxStream( const std::string& filePath, FbxCompression compression );
+		~CompressedFbxStream() override;
+
+		/// Returns true when the file could not be decompressed, e.g. because it is
+		/// truncated. Unlike GetError(), this is not reset by ClearError().
+		bool HasFailed() const;
+
+		/// Returns true when the decompressed content starts with the binary Fbx header.
+		bool IsBinaryFbx() const;
+
+		/// Decompresses the whole file to a temporary file, deleted with this
+		/// stream, and returns its path. Returns an empty string on failure.
+		std::string Spool( const CancelToken& cancelToken );
+
+		/// Reader used by the importer, see FbxIOPluginRegistry::FindReaderIDByDescription.
+		void SetReaderID( int readerId )
+		{
+			m_readerId = readerId;
+		}
+
+		EState GetState() override;
+		bool Open( void* streamData ) override;
+		bool Close() override;
+		bool Flush() override;
+		size_t Write( const void* data, FbxUInt64 size ) override;
+		size_t Read( void* data, FbxUInt64 size ) const override;
+		int GetReaderID() const override;
+		int GetWriterID() const override;
+		void Seek( const FbxInt64& offset, const FbxFile::ESeekPos& seekPos ) override;
+		FbxInt64 GetPosition() const override;
+		void SetPosition( FbxInt64 position ) override;
+		int GetError() const override;
+		void ClearError() override;
+
+		class Decompressor;
+
+	private:
+		// Decompresses until at least size bytes are available or the file ended.
+		// FbxStream::Read is const, hence the mutable state below.
+		void decompressUpTo( size_t size ) const;
+
+		std::unique_ptr< Decompressor > m_decompressor;
+		mutable std::vector< char > m_data;
+		mutable size_t m_position = 0;
+		mutable bool m_complete = false;
+		mutable bool m_error = false;
+		EState m_state = eClosed;
+		int m_readerId = -1;
+		std::string m_spoolPath;
+	};
+} // namespace remedy
@@ -15,4 +15,5 @@ TF_REGISTRY_FUNCTION( TfEnum )
 	TF_ADD_ENUM_NAME( UsdFbxError::FBX_INCOMPATIBLE_VERSIONS, "Incompatible versions between the SDK and the file used" );
 	TF_ADD_ENUM_NAME( UsdFbxError::USDFBX_INVALID_LAYER, "Invalid target layer" );
 	TF_ADD_ENUM_NAME( UsdFbxError::USDFBX_WRITE_TO_FBX_ERROR, "Error Writing Fbx from Usd" );
+	TF_ADD_ENUM_NAME( UsdFbxError::USDFBX_OPEN_CANCELLED, "Fbx open cancelled" );
 };
@@ -10,5 +10,6 @@ enum class UsdFbxError
 
 	// USDFBX plugin related
 	USDFBX_INVALID_LAYER,
-	USDFBX_WRITE_TO_FBX_ERROR
+	USDFBX_WRITE_TO_FBX_ERROR,
+	USDFBX_OPEN_CANCELLED
 };
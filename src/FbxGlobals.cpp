@@ -0,0 +1,115 @@
+// Copyright (C) Remedy Entertainment Plc.
+
+#include "FbxGlobals.h"
+
+#include "DebugCodes.h"
+#include "PrecompiledHeader.h"
+
+#include <pxr/base/tf/envSetting.h>
+#include <pxr/base/tf/registryManager.h>
+#include <pxr/base/tf/type.h>
+#include <pxr/base/trace/trace.h>
+
+#include <cstdlib>
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+TF_DEFINE_ENV_SETTING( USDFBX_PREWARM, false, "Warm up the Fbx SDK on a background thread when the usdFbx plugin is loaded" );
+
+// Registry functions are executed when the plugin library is loaded. USD loads it on
+// the first Fbx open unless the host loads it earlier, see remedy::Prewarm().
+TF_REGISTRY_FUNCTION( TfType )
+{
+	if( TfGetEnvSetting( USDFBX_PREWARM ) )
+	{
+		TF_DEBUG( USDFBX ).Msg( "UsdFbx - USDFBX_PREWARM is set, warming up the Fbx SDK\n" );
+		remedy::Prewarm();
+	}
+}
+
+remedy::FbxGlobals& remedy::FbxGlobals::getInstance()
+{
+	// Never destroyed, the threads converting Fbx files in the background use it
+	// until they are stopped at exit (see UsdFbxLayerCache::Shutdown)
+	static FbxGlobals* instance = new FbxGlobals();
+	return *instance;
+}
+
+remedy::FbxGlobals::FbxGlobals()
+{
+	m_fbxManager.reset( FbxManager::Create() );
+}
+
+remedy::FbxGlobals::IOSettingsHandle remedy::FbxGlobals::acquireIOSettings()
+{
+	FbxPtr< FbxIOSettings > ioSettings;
+	{
+		std::lock_guard lock( m_ioSettingsMutex );
+		if( !m_ioSettingsPool.empty() )
+		{
+			ioSettings = std::move( m_ioSettingsPool.back() );
+			m_ioSettingsPool.pop_back();
+		}
+	}
+	if( !ioSettings )
+	{
+		ioSettings.reset( FbxIOSettings::Create( m_fbxManager.get(), IOSROOT ) );
+	}
+
+	// An import may have changed them, every checkout starts from the same options
+	ioSettings->SetBoolProp( IMP_FBX_MATERIAL, true );
+	ioSettings->SetBoolProp( IMP_FBX_TEXTURE, true );
+	ioSettings->SetBoolProp( IMP_FBX_LINK, true );
+	ioSettings->SetBoolProp( IMP_FBX_SHAPE, true );
+	ioSettings->SetBoolProp( IMP_FBX_GOBO, true );
+	ioSettings->SetBoolProp( IMP_FBX_ANIMATION, true );
+	ioSettings->SetBoolProp( IMP_FBX_GLOBAL_SETTINGS, true );
+
+	return IOSettingsHandle(
+		ioSettings.release(),
+		[ this ]( FbxIOSettings* released )
+		{
+			std::lock_guard lock( m_ioSettingsMutex );
+			m_ioSettingsPool.emplace_back( released );
+		} );
+}
+
+std::shared_future< void > remedy::FbxGlobals::prewarm()
+{
+	std::lock_guard lock( m_prewarmMutex );
+	if( !m_prewarm.valid() )
+	{
+		m_prewarm = std::async( std::launch::async, [ this ]() { warmUp(); } ).share();
+		// The instance is never destroyed, the warm-up is waited upon before the Fbx SDK is torn down
+		std::atexit( []() { getInstance().getPrewarm().wait(); } );
+	}
+	return m_prewarm;
+}
+
+std::shared_future< void > remedy::FbxGlobals::getPrewarm()
+{
+	std::lock_guard lock( m_prewarmMutex );
+	return m_prewarm;
+}
+
+void remedy::FbxGlobals::warmUp()
+{
+	TRACE_FUNCTION()
+	std::lock_guard lock( m_mutex );
+
+	// Leaves an instance in the pool for the first import
+	acquireIOSettings();
+
+	// Creating a throwaway importer and scene faults in the reader plugins and the
+	// SDK pages that the first real import would otherwise pay for.
+	const FbxIOPluginRegistry* registry = m_fbxManager->GetIOPluginRegistry();
+	const auto importer = FbxPtr< FbxImporter >( FbxImporter::Create( m_fbxManager.get(), "" ) );
+	const auto scene = FbxPtr< FbxScene >( FbxScene::Create( m_fbxManager.get(), "" ) );
+
+	TF_DEBUG( USDFBX ).Msg( "UsdFbx - Fbx SDK warmed up (%d reader formats)\n", registry->GetReaderFormatCount() );
+}
+
+std::shared_future< void > remedy::Prewarm()
+{
+	return FbxGlobals::getInstance().prewarm();
+}
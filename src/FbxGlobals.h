@@ -0,0 +1,77 @@
+// Copyright (C) Remedy Entertainment Plc.
+
+#pragma once
+
+#include "Api.h"
+#include "UsdFbxDataReader.h"
+
+#include <fbxsdk.h>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace remedy
+{
+	/// Process wide Fbx SDK state shared by every Fbx layer.
+	///
+	/// The FbxManager is not thread safe, any access to it (or to objects created
+	/// through it) must hold the mutex returned by getMutex().
+	class FbxGlobals
+	{
+	public:
+		static FbxGlobals& getInstance();
+
+		FbxManager* getManager() const
+		{
+			return m_fbxManager.get();
+		}
+
+		std::mutex& getMutex()
+		{
+			return m_mutex;
+		}
+
+		/// Import settings checked out of the pool, returned to it when destroyed.
+		using IOSettingsHandle = std::unique_ptr< FbxIOSettings, std::function< void( FbxIOSettings* ) > >;
+
+		/// Checks import settings out of a pool, so that every import gets an instance
+		/// of its own while the instances are reused across opens. The settings are
+		/// reset to the plugin's import options on every checkout. The caller must
+		/// hold getMutex(), new instances are created through the manager.
+		IOSettingsHandle acquireIOSettings();
+
+		/// Initializes the manager, the import settings and the SDK reader plugins on
+		/// a background thread. Subsequent calls return the same future.
+		std::shared_future< void > prewarm();
+
+		/// Returns the future of the warm-up, which is not valid when prewarm() has
+		/// never been called.
+		std::shared_future< void > getPrewarm();
+
+		FbxGlobals( const FbxGlobals& ) = delete;
+		void operator=( const FbxGlobals& ) = delete;
+
+	private:
+		FbxGlobals();
+
+		void warmUp();
+
+		FbxPtr< FbxManager > m_fbxManager;
+		std::mutex m_mutex;
+
+		std::mutex m_ioSettingsMutex;
+		std::vector< FbxPtr< FbxIOSettings > > m_ioSettingsPool;
+
+		std::mutex m_prewarmMutex;
+		std::shared_future< void > m_prewarm;
+	};
+
+	/// Warms up the Fbx SDK on a background thread so the first Fbx layer opened in
+	/// the process does not pay for it. Opens that start before the warm-up is done
+	/// simply wait for it. Setting USDFBX_PREWARM=1 does the same when the plugin
+	/// library is loaded, which USD otherwise delays until the first Fbx open: hosts
+	/// load it early through PlugPlugin::Load() or by importing the usdFbx Python module.
+	USDFBX_API std::shared_future< void > Prewarm();
+} // namespace remedy
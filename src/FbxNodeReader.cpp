@@ -4,18 +4,23 @@
 
 #include "DebugCodes.h"
 #include "Helpers.h"
+#include "MeshProcessing.h"
 #include "PrecompiledHeader.h"
 #include "Tokens.h"
 
 #include <algorithm>
+#include <cmath>
 #include <numeric>
 #include <utility>
 
 DIAGNOSTIC_PUSH
 IGNORE_USD_WARNINGS
+#include <pxr/base/gf/math.h>
+#include <pxr/base/gf/quatd.h>
 #include <pxr/usd/sdf/schema.h>
 #include <pxr/usd/sdr/shaderProperty.h>
 #include <pxr/usd/usd/tokens.h>
+#include <pxr/usd/usdGeom/pointBased.h>
 #include <pxr/usd/usdGeom/tokens.h>
 #include <pxr/usd/usdGeom/xformOp.h>
 #include <pxr/usd/usdSkel/tokens.h>
@@ -53,6 +58,15 @@ namespace helpers
 		return { static_cast< float >( src.mRed ), static_cast< float >( src.mGreen ), static_cast< float >( src.mBlue ) };
 	}
 
+	// Narrows every element of values to halfs, e.g. a VtVec3fArray to a VtVec3hArray
+	template< typename HalfVec, typename Vec >
+	VtArray< HalfVec > toHalfArray( const VtArray< Vec >& values )
+	{
+		VtArray< HalfVec > result( values.size() );
+		std::transform( values.cbegin(), values.cend(), result.begin(), []( const Vec& v ) { return HalfVec( v ); } );
+		return result;
+	}
+
 	template< typename T >
 	T getAtVertexIndex( const FbxLayerElementTemplate< T >* pLayerElement, int iVertexIndex )
 	{
@@ -156,9 +170,15 @@ namespace helpers
 				return SdfValueTypeNames->Matrix4d;
 			case eFbxTime:
 				return SdfValueTypeNames->TimeCode;
+			// Tokens are never freed, they are only used for the short names of enum
+			// values. Strings and blobs can be arbitrarily large (JSON payloads, tool
+			// metadata) and are stored by value.
+			case eFbxEnum:
+				return SdfValueTypeNames->Token;
 			case eFbxBlob:
+				return SdfValueTypeNames->UCharArray;
 			case eFbxString:
-				return SdfValueTypeNames->Token;
+				return SdfValueTypeNames->String;
 			default:
 				return SdfValueTypeNames->Token;
 			}
@@ -221,11 +241,20 @@ namespace helpers
 				return VtValue( UsdTimeCode( fbxProperty->Get< FbxTime >().GetFrameCountPrecise() ) );
 			case eFbxDistance:
 				return VtValue( fbxProperty->Get< FbxDistance >().value() );
+			case eFbxEnum:
+			{
+				const int index = fbxProperty->Get< FbxEnum >();
+				const char* name = fbxProperty->GetEnumValue( index );
+				return VtValue( TfToken( name != nullptr ? name : TfStringify( index ) ) );
+			}
 			case eFbxBlob:
-				// Maybe not the most kosher thing on the planet, but eh
-				return VtValue( TfToken( static_cast< const char* >( fbxProperty->Get< FbxBlob >().Access() ) ) );
+			{
+				const FbxBlob blob = fbxProperty->Get< FbxBlob >();
+				const auto* bytes = static_cast< const uint8_t* >( blob.Access() );
+				return VtValue( bytes != nullptr ? VtUCharArray( bytes, bytes + blob.Size() ) : VtUCharArray() );
+			}
 			case eFbxString:
-				return VtValue( TfToken( fbxProperty->Get< FbxString >().Buffer() ) );
+				return VtValue( std::string( fbxProperty->Get< FbxString >().Buffer() ) );
 			default:
 				return VtValue( TfToken( "UNKNOWN TYPE" ) );
 			}
@@ -290,11 +319,14 @@ namespace helpers
 		}
 	};
 
+	// Both samplers return no samples at all when cancelled half way, a property
+	// is either fully animated or left static.
 	std::vector< std::tuple< UsdTimeCode, VtValue > > getPropertyAnimation(
 		FbxNode* node,
 		std::function< VtValue( FbxNode*, FbxTime ) >& valueAtTimeFn,
 		FbxAnimLayer* animLayer,
-		FbxTimeSpan& animTimeSpan )
+		FbxTimeSpan& animTimeSpan,
+		const remedy::CancelToken& cancelToken )
 	{
 		std::vector< std::tuple< UsdTimeCode, VtValue > > result = {};
 		if( animLayer == nullptr )
@@ -304,6 +336,10 @@ namespace helpers
 
 		for( auto frame = animTimeSpan.GetStart().GetFrameCount(); frame <= animTimeSpan.GetStop().GetFrameCount(); ++frame )
 		{
+			if( cancelToken.IsCancelled() )
+			{
+				return {};
+			}
 			FbxTime currentFrame;
 			currentFrame.SetFrame( frame );
 			result.push_back( { UsdTimeCode( static_cast< double >( frame ) ), valueAtTimeFn( node, currentFrame ) } );
@@ -311,24 +347,21 @@ namespace helpers
 		return result;
 	}
 
+	// Properties missing from the index are not animated and return right away,
+	// without asking the evaluator for a curve node
 	std::vector< std::tuple< UsdTimeCode, VtValue > > getPropertyAnimation(
-		FbxNode* node,
 		FbxProperty& fbxProperty,
-		FbxAnimLayer* animLayer,
-		FbxTimeSpan& animTimeSpan )
+		const remedy::FbxPropertyIndex& propertyIndex,
+		const std::vector< FbxTime >& sampleTimes,
+		const remedy::CancelToken& cancelToken )
 	{
 		std::vector< std::tuple< UsdTimeCode, VtValue > > result = {};
-		if( animLayer == nullptr )
-		{
-			return result;
-		}
-
 		if( !fbxProperty.IsValid() )
 		{
 			return result;
 		}
 
-		const auto curveNode = node->GetAnimationEvaluator()->GetPropertyCurveNode( fbxProperty, animLayer );
+		const auto curveNode = propertyIndex.GetCurveNode( fbxProperty );
 		if( curveNode == nullptr )
 		{
 			return result;
@@ -349,10 +382,8 @@ namespace helpers
 			return result;
 		}
 
-		const size_t numKeys = animTimeSpan.GetDuration().GetFrameCount() + 1;
 		const std::vector< float > defaultChannelsValue( curveNode->GetChannelsCount(), 0.0f );
-		std::vector< std::vector< float > > channelValues( numKeys, defaultChannelsValue );
-		std::set< UsdTimeCode > timeCodes;
+		std::vector< std::vector< float > > channelValues( sampleTimes.size(), defaultChannelsValue );
 
 		for( unsigned channelId = 0u; channelId < curveNode->GetChannelsCount(); ++channelId )
 		{
@@ -365,59 +396,107 @@ namespace helpers
 			{
 				continue;
 			}
-			// We can't use keyCount, we have to use Evaluate and step through one frame
-			// at a time
-			size_t index = 0;
-			for( auto frame = animTimeSpan.GetStart().GetFrameCount(); frame <= animTimeSpan.GetStop().GetFrameCount(); ++frame )
+			// We can't use keyCount, we have to use Evaluate and step through one
+			// sample at a time
+			for( size_t index = 0; index < sampleTimes.size(); ++index )
 			{
-				timeCodes.insert( UsdTimeCode( static_cast< double >( frame ) ) );
-				FbxTime currentFrame;
-				currentFrame.SetFrame( frame );
-				channelValues[ index ][ channelId ] = animCurve->Evaluate( currentFrame );
-				++index;
+				if( cancelToken.IsCancelled() )
+				{
+					return {};
+				}
+				channelValues[ index ][ channelId ] = animCurve->Evaluate( sampleTimes[ index ] );
 			}
 		}
 		FbxToUsd propertyConverter{ &fbxProperty };
 
-		std::transform(
-			channelValues.begin(),
-			channelValues.end(),
-			timeCodes.begin(),
-			std::back_inserter( result ),
-			[ & ]( const auto& channelValue, const auto& timeCode ) -> std::tuple< UsdTimeCode, VtValue >
-			{
-				VtValue val = propertyConverter.getValue( channelValue );
-				return { timeCode, val };
-			} );
-
+		result.reserve( sampleTimes.size() );
+		for( size_t index = 0; index < sampleTimes.size(); ++index )
+		{
+			const UsdTimeCode timeCode( sampleTimes[ index ].GetFrameCountPrecise() );
+			result.push_back( { timeCode, propertyConverter.getValue( channelValues[ index ] ) } );
+		}
 		return result;
 	}
 
-	std::vector< FbxProperty > getUserProperties( const FbxNode* fbxNode )
+	std::vector< std::tuple< UsdTimeCode, VtValue > > getPropertyAnimation(
+		FbxProperty& fbxProperty,
+		const remedy::FbxPropertyIndex& propertyIndex,
+		FbxTimeSpan& animTimeSpan,
+		const remedy::CancelToken& cancelToken )
 	{
-		std::vector< FbxProperty > result;
-		for( FbxProperty fbxProperty = fbxNode->GetFirstProperty(); fbxProperty.IsValid();
-			 fbxProperty = fbxNode->GetNextProperty( fbxProperty ) )
+		std::vector< FbxTime > sampleTimes;
+		for( auto frame = animTimeSpan.GetStart().GetFrameCount(); frame <= animTimeSpan.GetStop().GetFrameCount(); ++frame )
 		{
-			if( !fbxProperty.GetFlag( FbxPropertyFlags::EFlags::eUserDefined ) )
-			{
-				continue;
-			}
-			result.push_back( fbxProperty );
+			FbxTime currentFrame;
+			currentFrame.SetFrame( frame );
+			sampleTimes.push_back( currentFrame );
 		}
-		return result;
+		return getPropertyAnimation( fbxProperty, propertyIndex, sampleTimes, cancelToken );
 	}
 
-	std::vector< FbxProperty > getAnimatedUserProperties( const FbxNode* fbxNode, FbxAnimLayer* animLayer )
+	// Returns the number of intervals to split a frame into, for a transform that
+	// moves by distance and turns by angle (in degrees) over it
+	int getFrameSubdivisions( double distance, double angle, const remedy::UsdFbxDataReader::Options& options )
 	{
-		auto res = getUserProperties( fbxNode );
-		res.erase(
-			std::remove_if(
-				res.begin(),
-				res.end(),
-				[ & ]( FbxProperty& prop ) { return prop.GetCurveNode( animLayer ) == nullptr; } ),
-			res.end() );
-		return res;
+		if( options.maxSubframes <= 0 )
+		{
+			return 1;
+		}
+		const double needed
+			= std::max( distance / options.subframeLinearThreshold, angle / options.subframeAngularThreshold );
+		return std::clamp( static_cast< int >( std::ceil( needed ) ), 1, options.maxSubframes + 1 );
+	}
+
+	// Returns how far the local transform moves, and how much it turns in degrees,
+	// between from and to
+	std::pair< double, double > getTransformDelta( const GfMatrix4d& from, const GfMatrix4d& to )
+	{
+		const double distance = ( to.ExtractTranslation() - from.ExtractTranslation() ).GetLength();
+		const GfQuatd q0 = from.ExtractRotationQuat();
+		const GfQuatd q1 = to.ExtractRotationQuat();
+		const double dot = std::abs( q0.GetReal() * q1.GetReal() + GfDot( q0.GetImaginary(), q1.GetImaginary() ) );
+		return { distance, GfRadiansToDegrees( 2.0 * std::acos( std::min( dot, 1.0 ) ) ) };
+	}
+
+	// Sample times for the transform of node, every frame plus subframes over the
+	// frames where it moves faster than the thresholds of the options. Returns
+	// nothing when no frame needs subframes, or adaptive sampling is disabled.
+	std::vector< FbxTime > getAdaptiveSampleTimes( remedy::FbxNodeReaderContext& context )
+	{
+		const auto& options = context.GetDataReader().GetOptions();
+		FbxNode* node = context.GetNode();
+		if( options.maxSubframes <= 0 || context.GetAnimLayer() == nullptr
+			|| ( !context.GetPropertyIndex().IsAnimated( node->LclTranslation )
+				 && !context.GetPropertyIndex().IsAnimated( node->LclRotation ) ) )
+		{
+			return {};
+		}
+
+		FbxAnimEvaluator* evaluator = node->GetScene()->GetAnimationEvaluator();
+		const FbxTime frameIncrement( FbxTime::GetOneFrameValue( node->GetScene()->GetGlobalSettings().GetTimeMode() ) );
+		const FbxTimeSpan& span = context.GetAnimTimeSpan();
+		std::vector< FbxTime > sampleTimes;
+		bool hasSubframes = false;
+		GfMatrix4d previous = toGfMatrix( evaluator->GetNodeLocalTransform( node, span.GetStart() ) );
+		sampleTimes.push_back( span.GetStart() );
+		for( FbxTime time = span.GetStart() + frameIncrement; time <= span.GetStop(); time += frameIncrement )
+		{
+			if( context.IsCancelled() )
+			{
+				return {};
+			}
+			const GfMatrix4d current = toGfMatrix( evaluator->GetNodeLocalTransform( node, time ) );
+			const auto [ distance, angle ] = getTransformDelta( previous, current );
+			const int subdivisions = getFrameSubdivisions( distance, angle, options );
+			for( int i = 1; i < subdivisions; ++i )
+			{
+				sampleTimes.push_back( time - frameIncrement + FbxTime( frameIncrement.Get() * i / subdivisions ) );
+			}
+			hasSubframes = hasSubframes || subdivisions > 1;
+			sampleTimes.push_back( time );
+			previous = current;
+		}
+		return hasSubframes ? sampleTimes : std::vector< FbxTime >();
 	}
 
 	double toOneTenthOfScene( double value, FbxSystemUnit systemUnits )
@@ -943,7 +1022,7 @@ namespace
 	{
 		TF_DEBUG( USDFBX_FBX_READERS )
 			.Msg( "UsdFbx::FbxReaders - readUserProperties for \"%s\"\n", context.GetNode()->GetName() );
-		for( FbxProperty fbxProperty : helpers::getUserProperties( context.GetNode() ) )
+		for( FbxProperty fbxProperty : context.GetPropertyIndex().GetUserProperties( context.GetNode() ) )
 		{
 			helpers::FbxToUsd propertyConverter{ &fbxProperty };
 			auto valueType = propertyConverter.getSdfTypeName();
@@ -1036,6 +1115,10 @@ namespace
 	void readMesh( remedy::FbxNodeReaderContext& context )
 	{
 		TF_DEBUG( USDFBX_FBX_READERS ).Msg( "UsdFbx::FbxReaders - readMesh for \"%s\"\n", context.GetNode()->GetName() );
+		if( context.IsCancelled() )
+		{
+			return;
+		}
 		context.GetOrAddPrim().typeName = UsdFbxPrimTypeNames->Mesh;
 
 		const FbxNode* fbxNode = context.GetNode();
@@ -1045,62 +1128,127 @@ namespace
 			return;
 		}
 
+		VtVec3fArray points = converters::meshPoints( context.GetNode() );
+		VtIntArray faceVertexCounts = converters::meshFaceVertexCounts( context.GetNode() );
+		VtIntArray faceVertexIndices = converters::meshFaceVertexIndices( context.GetNode() );
+
+		// Every per point and face varying array below goes through the remaps, in order
+		std::vector< remedy::MeshRemap > remaps;
+		const auto addRemap = [ & ]( remedy::MeshRemap remap )
+		{
+			if( !remap.IsIdentity() )
+			{
+				points = remap.RemapVertices( points );
+				faceVertexCounts = remap.GetFaceVertexCounts();
+				faceVertexIndices = remap.GetFaceVertexIndices();
+				remaps.push_back( std::move( remap ) );
+			}
+		};
+		// Arrays the remaps cannot map come back empty and are not authored
+		const auto remapVertices = [ & ]( auto values, size_t elementSize = 1 )
+		{
+			for( const auto& remap : remaps )
+			{
+				values = remap.RemapVertices( values, elementSize );
+			}
+			return values;
+		};
+		const auto remapFaceVertices = [ & ]( auto values )
+		{
+			for( const auto& remap : remaps )
+			{
+				values = remap.RemapFaceVertices( values );
+			}
+			return values;
+		};
+
+		const auto& options = context.GetDataReader().GetOptions();
+		if( options.cleanMeshes )
+		{
+			auto cleanup = remedy::MeshRemap::Clean( points, faceVertexCounts, faceVertexIndices );
+			TF_DEBUG( USDFBX_FBX_READERS )
+				.Msg(
+					"UsdFbx::FbxReaders - readMesh removed %zu degenerate faces and %zu unreferenced points from \"%s\"\n",
+					cleanup.GetRemovedFaceCount(),
+					cleanup.GetRemovedPointCount(),
+					fbxNode->GetName() );
+			addRemap( std::move( cleanup ) );
+		}
+		if( options.optimizeVertexCache )
+		{
+			addRemap( remedy::MeshRemap::OptimizeVertexCache( points.size(), faceVertexCounts, faceVertexIndices ) );
+		}
+
 		// Varying/Interpolated properties
 		context.CreateProperty(
 			UsdGeomTokens->points,
 			SdfValueTypeNames->Point3fArray,
-			VtValue( converters::meshPoints( context.GetNode() ) ),
+			VtValue::Take( points ),
 			{ helpers::getDisplayGroupMetadata( UsdFbxDisplayGroupTokens->geometry ) } );
 
 		// TODO - Post 1.0: potentially use primvars:normals/tangents instead.
 		// primvars:normals/tangents takes precendence over
 		// UsdGeomPointBased::normals/tangents
-		context.CreateProperty(
-			UsdGeomTokens->normals,
-			SdfValueTypeNames->Normal3fArray,
-			VtValue( converters::meshNormals( context.GetNode() ) ),
-			{ helpers::getDisplayGroupMetadata( UsdFbxDisplayGroupTokens->geometry ),
-			  { UsdGeomTokens->interpolation, VtValue( UsdGeomTokens->faceVarying ) } } );
-
-		context.CreateProperty(
-			UsdGeomTokens->tangents,
-			SdfValueTypeNames->Normal3fArray,
-			VtValue( converters::meshTangents( context.GetNode() ) ),
-			{ helpers::getDisplayGroupMetadata( UsdFbxDisplayGroupTokens->geometry ),
-			  { UsdGeomTokens->interpolation, VtValue( UsdGeomTokens->faceVarying ) } } );
+		const bool reducedPrecision = options.reducedPrecision;
+		const SdfValueTypeName normalTypeName
+			= reducedPrecision ? SdfValueTypeNames->Normal3hArray : SdfValueTypeNames->Normal3fArray;
+		VtVec3fArray normals = remapFaceVertices( converters::meshNormals( context.GetNode() ) );
+		if( !normals.empty() )
+		{
+			context.CreateProperty(
+				UsdGeomTokens->normals,
+				normalTypeName,
+				reducedPrecision ? VtValue( helpers::toHalfArray< GfVec3h >( normals ) ) : VtValue::Take( normals ),
+				{ helpers::getDisplayGroupMetadata( UsdFbxDisplayGroupTokens->geometry ),
+				  { UsdGeomTokens->interpolation, VtValue( UsdGeomTokens->faceVarying ) } } );
+		}
 
-		if( helpers::hasVertexColors( fbxNode ) )
+		VtVec3fArray tangents = remapFaceVertices( converters::meshTangents( context.GetNode() ) );
+		if( !tangents.empty() )
 		{
 			context.CreateProperty(
-				UsdGeomTokens->primvarsDisplayColor,
-				SdfValueTypeNames->Color3f,
-				VtValue( converters::meshVertexColors( context.GetNode() ) ),
-				nullptr,
-				// TODO - Post 1.0: Add fbx property for color animation
+				UsdGeomTokens->tangents,
+				normalTypeName,
+				reducedPrecision ? VtValue( helpers::toHalfArray< GfVec3h >( tangents ) ) : VtValue::Take( tangents ),
 				{ helpers::getDisplayGroupMetadata( UsdFbxDisplayGroupTokens->geometry ),
-				  { UsdGeomTokens->interpolation, VtValue( UsdGeomTokens->vertex ) } } );
+				  { UsdGeomTokens->interpolation, VtValue( UsdGeomTokens->faceVarying ) } } );
+		}
+
+		if( helpers::hasVertexColors( fbxNode ) )
+		{
+			VtVec3fArray colors = remapVertices( converters::meshVertexColors( context.GetNode() ) );
+			if( !colors.empty() )
+			{
+				context.CreateProperty(
+					UsdGeomTokens->primvarsDisplayColor,
+					SdfValueTypeNames->Color3f,
+					VtValue::Take( colors ),
+					nullptr,
+					// TODO - Post 1.0: Add fbx property for color animation
+					{ helpers::getDisplayGroupMetadata( UsdFbxDisplayGroupTokens->geometry ),
+					  { UsdGeomTokens->interpolation, VtValue( UsdGeomTokens->vertex ) } } );
+			}
 		}
 
 		context.CreateProperty(
 			UsdGeomTokens->faceVertexCounts,
 			SdfValueTypeNames->IntArray,
-			VtValue( converters::meshFaceVertexCounts( context.GetNode() ) ),
+			VtValue::Take( faceVertexCounts ),
 			{ helpers::getDisplayGroupMetadata( UsdFbxDisplayGroupTokens->geometry ) } );
 
 		context.CreateProperty(
 			UsdGeomTokens->faceVertexIndices,
 			SdfValueTypeNames->IntArray,
-			VtValue( converters::meshFaceVertexIndices( context.GetNode() ) ),
+			VtValue::Take( faceVertexIndices ),
 			{ helpers::getDisplayGroupMetadata( UsdFbxDisplayGroupTokens->geometry ) } );
 
-		if( const auto* skin = helpers::getSkin( static_cast< const FbxMesh* >( fbxNode->GetNodeAttribute() ) ) )
+		const auto* skin = helpers::getSkin( static_cast< const FbxMesh* >( fbxNode->GetNodeAttribute() ) );
+		if( skin && !context.IsCancelled() )
 		{
-			context.GetOrAddPrim().metadata.emplace(
-				UsdTokens->apiSchemas,
-				VtValue( SdfTokenListOp::Create( { TfToken( "SkelBindingAPI" ) } ) ) );
-
-			const auto& [ joints, jointIndices, jointWeights, elementSize, skeletonPath ]
+			auto [ joints, jointIndices, jointWeights, elementSize, skeletonPath ]
 				= converters::getBindingData( skin, static_cast< const FbxMesh* >( fbxNode->GetNodeAttribute() ) );
+			jointIndices = remapVertices( jointIndices, static_cast< size_t >( elementSize ) );
+			jointWeights = remapVertices( jointWeights, static_cast< size_t >( elementSize ) );
 
 			if( joints.empty() )
 			{
@@ -1109,8 +1257,17 @@ namespace
 					"extracted!",
 					fbxNode->GetName() );
 			}
+			else if( jointIndices.empty() || jointWeights.empty() )
+			{
+				TF_WARN( "The joint influences of \"%s\" could not be remapped, its skin is dropped", fbxNode->GetName() );
+			}
 			else
 			{
+				// Only once there is a binding to author, a mesh whose skin was dropped is not bound
+				context.GetOrAddPrim().metadata.emplace(
+					UsdTokens->apiSchemas,
+					VtValue( SdfTokenListOp::Create( { TfToken( "SkelBindingAPI" ) } ) ) );
+
 				auto matrix = fbxNode->GetScene()->GetAnimationEvaluator()->GetNodeGlobalTransform( context.GetNode() );
 				matrix.SetS( { 1.0, 1.0, 1.0 } );
 				const GfMatrix4d geomBindTransform( helpers::toGfMatrix( matrix ) );
@@ -1164,7 +1321,7 @@ namespace
 		{
 			const auto mesh = static_cast< const FbxMesh* >( fbxNode->GetNodeAttribute() );
 			const int layerCount = mesh->GetLayerCount();
-			for( int i = 0; i != layerCount; ++i )
+			for( int i = 0; i != layerCount && !context.IsCancelled(); ++i )
 			{
 				const auto layer = mesh->GetLayer( i );
 
@@ -1175,10 +1332,15 @@ namespace
 					continue;
 				}
 				std::string suffix = layerCount > 1 ? ( boost::format( "_%1%" ) % layerElement->GetName() ).str() : "";
+				VtVec2fArray texCoords = remapFaceVertices( converters::meshTexCoords( context.GetNode(), i ) );
+				if( texCoords.empty() )
+				{
+					continue;
+				}
 				context.CreateProperty(
 					TfToken( ( boost::format( "primvars:st%1%" ) % suffix ).str().c_str() ),
-					SdfValueTypeNames->TexCoord2fArray,
-					VtValue( converters::meshTexCoords( context.GetNode(), i ) ),
+					reducedPrecision ? SdfValueTypeNames->TexCoord2hArray : SdfValueTypeNames->TexCoord2fArray,
+					reducedPrecision ? VtValue( helpers::toHalfArray< GfVec2h >( texCoords ) ) : VtValue::Take( texCoords ),
 					nullptr,
 					{ { UsdGeomTokens->interpolation, VtValue( UsdGeomTokens->faceVarying ) },
 					  helpers::getDisplayGroupMetadata( UsdFbxDisplayGroupTokens->geometry ) } );
@@ -1206,7 +1368,7 @@ namespace
 	void readSkeletonAnimation( remedy::FbxNodeReaderContext& context )
 	{
 		TF_DEBUG( USDFBX_FBX_READERS ).Msg( "UsdFbx::FbxReaders - readSkeletonAnim for \"%s\"\n", context.GetNode()->GetName() );
-		if( context.GetAnimLayer() == nullptr )
+		if( context.GetAnimLayer() == nullptr || context.IsCancelled() )
 		{
 			return;
 		}
@@ -1291,8 +1453,8 @@ namespace
 		size_t idx = 0;
 		for( auto* skeleton : skeletonHierarchy )
 		{
-			auto fbxProps = helpers::getAnimatedUserProperties( skeleton->GetNode(), context.GetAnimLayer() );
-			if( skeleton->GetNode()->Visibility.GetCurveNode( context.GetAnimLayer() ) )
+			auto fbxProps = context.GetPropertyIndex().GetAnimatedUserProperties( skeleton->GetNode() );
+			if( context.GetPropertyIndex().IsAnimated( skeleton->GetNode()->Visibility ) )
 			{
 				fbxProps.push_back( skeleton->GetNode()->Visibility );
 			}
@@ -1311,10 +1473,10 @@ namespace
 
 				auto& prop = propertiesMapIt->second;
 				auto timeAndValue = helpers::getPropertyAnimation(
-					skeleton->GetNode(),
 					fbxProp,
-					context.GetAnimLayer(),
-					context.GetAnimTimeSpan() );
+					context.GetPropertyIndex(),
+					context.GetAnimTimeSpan(),
+					context.GetDataReader().GetCancelToken() );
 				for( auto& [ time, value ] : timeAndValue )
 				{
 					auto it = prop.timeSamples.find( time );
@@ -1329,17 +1491,26 @@ namespace
 			}
 		}
 
-		for( uint64_t frame = 0; frame <= numFrames; ++frame )
+		const auto evaluateLocals = [ & ]( const FbxTime& time )
+		{
+			std::vector< GfMatrix4d > locals;
+			locals.reserve( skeletonHierarchy.size() );
+			for( const auto* skeleton : skeletonHierarchy )
+			{
+				locals.push_back( helpers::toGfMatrix( evaluator->GetNodeLocalTransform( skeleton->GetNode(), time ) ) );
+			}
+			return locals;
+		};
+
+		const auto addSample = [ & ]( const FbxTime& time, const std::vector< GfMatrix4d >& locals )
 		{
 			VtVec3fArray skeletonTranslations;
 			VtQuatfArray skeletonRotations;
 			VtVec3hArray skeletonScales;
-			UsdTimeCode t( fbxSampleTime.GetFrameCountPrecise() );
+			UsdTimeCode t( time.GetFrameCountPrecise() );
 
-			for( const auto* skeleton : skeletonHierarchy )
+			for( const GfMatrix4d& local : locals )
 			{
-				const GfMatrix4d local
-					= helpers::toGfMatrix( evaluator->GetNodeLocalTransform( skeleton->GetNode(), fbxSampleTime ) );
 				skeletonTranslations.push_back( GfVec3f( local.ExtractTranslation() ) );
 				skeletonRotations.push_back( GfQuatf( local.ExtractRotationQuat() ) );
 				skeletonScales.push_back( GfVec3h( 1.0f, 1.0f, 1.0f ) );
@@ -1348,7 +1519,36 @@ namespace
 			translations.push_back( { t, VtValue( skeletonTranslations ) } );
 			rotations.push_back( { t, VtValue( skeletonRotations ) } );
 			scales.push_back( { t, VtValue( skeletonScales ) } );
+		};
 
+		// With adaptive sampling, the fastest joint over a frame decides how many
+		// subframes the whole skeleton gets
+		const auto& options = context.GetDataReader().GetOptions();
+		std::vector< GfMatrix4d > previousLocals;
+		for( uint64_t frame = 0; frame <= numFrames; ++frame )
+		{
+			// Leaves an empty SkelAnimation behind, which the skeleton is not bound to yet
+			if( context.IsCancelled() )
+			{
+				return;
+			}
+
+			std::vector< GfMatrix4d > locals = evaluateLocals( fbxSampleTime );
+			int subdivisions = 1;
+			for( size_t joint = 0; options.maxSubframes > 0 && frame > 0 && joint < locals.size(); ++joint )
+			{
+				const auto [ distance, angle ] = helpers::getTransformDelta( previousLocals[ joint ], locals[ joint ] );
+				subdivisions = std::max( subdivisions, helpers::getFrameSubdivisions( distance, angle, options ) );
+			}
+			for( int i = 1; i < subdivisions; ++i )
+			{
+				const FbxTime subframeTime
+					= fbxSampleTime - fbxFrameIncrement + FbxTime( fbxFrameIncrement.Get() * i / subdivisions );
+				addSample( subframeTime, evaluateLocals( subframeTime ) );
+			}
+			addSample( fbxSampleTime, locals );
+
+			previousLocals = std::move( locals );
 			fbxSampleTime += fbxFrameIncrement;
 		}
 
@@ -1517,6 +1717,7 @@ namespace
 		// But doing anything with xformcommonAPI when there's a pre and/or post xform
 		// op in the list will not fly
 		context.GetNode()->ResetPivotSetAndConvertAnimation();
+		context.GetPropertyIndex().RefreshTransform( context.GetNode() );
 
 		const TfToken translate = UsdGeomXformOp::GetOpName( UsdGeomXformOp::TypeTranslate );
 		const TfToken pivot = UsdGeomXformOp::GetOpName( UsdGeomXformOp::TypeTranslate, UsdGeomTokens->pivot );
@@ -1552,32 +1753,74 @@ namespace
 			break;
 		}
 		}
+
+		// Fast moving transforms get subframe samples, for motion blur, when adaptive
+		// sampling is enabled. All the ops are then sampled at the same times.
+		const std::vector< FbxTime > sampleTimes = helpers::getAdaptiveSampleTimes( context );
+		const auto createXformOp = [ & ]( const TfToken& name,
+										  const SdfValueTypeName& typeName,
+										  VtValue&& value,
+										  FbxProperty& fbxProperty )
+		{
+			if( sampleTimes.empty() )
+			{
+				context.CreateProperty( name, typeName, std::move( value ), &fbxProperty );
+				return;
+			}
+			auto& prop = context.CreateProperty( name, typeName, std::move( value ) );
+			prop.timeSamples = helpers::getPropertyAnimation(
+				fbxProperty,
+				context.GetPropertyIndex(),
+				sampleTimes,
+				context.GetDataReader().GetCancelToken() );
+		};
+
 		// Scale and rotate pivots are collapsed into a singular translate/inv
 		// translate pivot op Usually the order is [translate, translatePivot, ... ,
 		// !invert!translatePivot] where ... are any of the rotation/scale/etc... ops
-		context.CreateProperty(
-			translate,
-			SdfValueTypeNames->Double3,
-			VtValue( converters::translation( context.GetNode() ) ),
-			&context.GetNode()->LclTranslation );
+		// With reduced precision, static translations are authored as floats. Animated
+		// ones keep the double precision of their samples.
+		const bool reducedPrecision = context.GetDataReader().GetOptions().reducedPrecision;
+		if( reducedPrecision && !context.GetPropertyIndex().IsAnimated( context.GetNode()->LclTranslation ) )
+		{
+			context.CreateProperty(
+				translate,
+				SdfValueTypeNames->Float3,
+				VtValue( GfVec3f( converters::translation( context.GetNode() ) ) ) );
+		}
+		else
+		{
+			createXformOp(
+				translate,
+				SdfValueTypeNames->Double3,
+				VtValue( converters::translation( context.GetNode() ) ),
+				context.GetNode()->LclTranslation );
+		}
 
-		context.CreateProperty(
-			pivot,
-			SdfValueTypeNames->Double3,
-			VtValue( converters::rotationPivot( context.GetNode() ) ),
-			&context.GetNode()->RotationPivot );
+		if( reducedPrecision && !context.GetPropertyIndex().IsAnimated( context.GetNode()->RotationPivot ) )
+		{
+			context.CreateProperty( pivot, SdfValueTypeNames->Float3, VtValue( converters::rotationPivot( context.GetNode() ) ) );
+		}
+		else
+		{
+			context.CreateProperty(
+				pivot,
+				SdfValueTypeNames->Double3,
+				VtValue( converters::rotationPivot( context.GetNode() ) ),
+				&context.GetNode()->RotationPivot );
+		}
 
-		context.CreateProperty(
+		createXformOp(
 			rotate,
 			SdfValueTypeNames->Float3,
 			VtValue( converters::rotation( context.GetNode() ) ),
-			&context.GetNode()->LclRotation );
+			context.GetNode()->LclRotation );
 
-		context.CreateProperty(
+		createXformOp(
 			scale,
 			SdfValueTypeNames->Float3,
 			VtValue( converters::scale( context.GetNode() ) ),
-			&context.GetNode()->LclScaling );
+			context.GetNode()->LclScaling );
 
 		context.CreateUniformProperty(
 			UsdGeomTokens->xformOpOrder,
@@ -1618,6 +1861,7 @@ remedy::FbxNodeReaders::FbxNodeReaders()
 	m_nodeTypeReaderMap.emplace( FbxNodeAttribute::eCameraSwitcher, FbxNodeReaderFnContainer() );
 	m_nodeTypeReaderMap.emplace( FbxNodeAttribute::eLight, FbxNodeReaderFnContainer() );
 	m_nodeTypeReaderMap.emplace( FbxNodeAttribute::eOpticalReference, FbxNodeReaderFnContainer() );
+	// Optical markers are read in batches by ReadOpticalMarkers, not one node at a time
 	m_nodeTypeReaderMap.emplace( FbxNodeAttribute::eOpticalMarker, FbxNodeReaderFnContainer() );
 	m_nodeTypeReaderMap.emplace( FbxNodeAttribute::eNurbsCurve, FbxNodeReaderFnContainer() );
 	m_nodeTypeReaderMap.emplace( FbxNodeAttribute::eTrimNurbsSurface, FbxNodeReaderFnContainer() );
@@ -1630,19 +1874,123 @@ remedy::FbxNodeReaders::FbxNodeReaders()
 	m_nodeTypeReaderMap.emplace( FbxNodeAttribute::eLine, FbxNodeReaderFnContainer() );
 }
 
+void remedy::ReadOpticalMarkers( FbxNodeReaderContext& context, const std::vector< FbxNode* >& markers )
+{
+	TF_DEBUG( USDFBX_FBX_READERS )
+		.Msg(
+			"UsdFbx::FbxReaders - ReadOpticalMarkers for %zu markers under \"%s\"\n",
+			markers.size(),
+			context.GetNode()->GetName() );
+	context.GetOrAddPrim().typeName = UsdFbxPrimTypeNames->Points;
+
+	VtInt64Array ids;
+	VtTokenArray names;
+	for( const FbxNode* marker : markers )
+	{
+		ids.push_back( static_cast< int64_t >( marker->GetUniqueID() ) );
+		names.push_back( TfToken( marker->GetName() ) );
+	}
+
+	// The Points prim inherits the transform of the markers' parent, the points are
+	// therefore the marker positions relative to it
+	FbxNode* parent = context.GetNode();
+	FbxAnimEvaluator* evaluator = parent->GetScene()->GetAnimationEvaluator();
+	auto pointsAt = [ & ]( const FbxTime& time )
+	{
+		const FbxAMatrix parentInverse = evaluator->GetNodeGlobalTransform( parent, time ).Inverse();
+		VtVec3fArray points( markers.size() );
+		for( size_t i = 0; i < markers.size(); ++i )
+		{
+			const FbxVector4 position = evaluator->GetNodeGlobalTransform( markers[ i ], time ).GetT();
+			points[ i ] = helpers::toGfVec( parentInverse.MultT( position ) );
+		}
+		return points;
+	};
+
+	// Every marker is evaluated at a given frame before moving to the next one,
+	// the evaluator caches the parent transforms they have in common
+	std::vector< std::tuple< UsdTimeCode, VtValue > > timeSamples;
+	if( context.GetAnimLayer() != nullptr )
+	{
+		const FbxTime fbxFrameIncrement( FbxTime::GetOneFrameValue( parent->GetScene()->GetGlobalSettings().GetTimeMode() ) );
+		const auto numFrames = static_cast< uint64_t >( context.GetAnimTimeSpan().GetDuration().GetFrameCount() );
+		FbxTime fbxSampleTime = context.GetAnimTimeSpan().GetStart();
+		for( uint64_t frame = 0; frame <= numFrames; ++frame )
+		{
+			if( context.IsCancelled() )
+			{
+				timeSamples.clear();
+				break;
+			}
+			const UsdTimeCode t( fbxSampleTime.GetFrameCountPrecise() );
+			timeSamples.push_back( { t, VtValue( pointsAt( fbxSampleTime ) ) } );
+			fbxSampleTime += fbxFrameIncrement;
+		}
+	}
+
+	const bool isAnimated = !timeSamples.empty()
+							&& !std::all_of(
+								timeSamples.begin() + 1,
+								timeSamples.end(),
+								[ & ]( const auto& sample )
+								{ return std::get< 1 >( sample ) == std::get< 1 >( timeSamples[ 0 ] ); } );
+
+	// Markers have no width, their extent is the bounds of their positions
+	auto extentOf = []( const VtValue& points )
+	{
+		VtVec3fArray extent( 2 );
+		UsdGeomPointBased::ComputeExtent( points.UncheckedGet< VtVec3fArray >(), &extent );
+		return VtValue( extent );
+	};
+
+	VtValue points = timeSamples.empty() ? VtValue( pointsAt( FbxTime() ) ) : std::get< 1 >( timeSamples[ 0 ] );
+	auto& extentProp = context.CreateProperty(
+		UsdGeomTokens->extent,
+		SdfValueTypeNames->Float3Array,
+		extentOf( points ),
+		{ helpers::getDisplayGroupMetadata( UsdFbxDisplayGroupTokens->geometry ) } );
+	auto& pointsProp = context.CreateProperty(
+		UsdGeomTokens->points,
+		SdfValueTypeNames->Point3fArray,
+		std::move( points ),
+		{ helpers::getDisplayGroupMetadata( UsdFbxDisplayGroupTokens->geometry ) } );
+	if( isAnimated )
+	{
+		for( const auto& [ time, sample ] : timeSamples )
+		{
+			extentProp.timeSamples.push_back( { time, extentOf( sample ) } );
+		}
+		pointsProp.timeSamples = std::move( timeSamples );
+	}
+
+	context.CreateProperty(
+		UsdGeomTokens->ids,
+		SdfValueTypeNames->Int64Array,
+		VtValue( ids ),
+		{ helpers::getDisplayGroupMetadata( UsdFbxDisplayGroupTokens->geometry ) } );
+
+	context.CreateUniformProperty(
+		TfToken( "generated:markerNames" ),
+		SdfValueTypeNames->TokenArray,
+		VtValue( names ),
+		{ helpers::getDisplayGroupMetadata( UsdFbxDisplayGroupTokens->generated ), { SdfFieldKeys->Custom, VtValue( true ) } } );
+}
+
 remedy::FbxNodeReaderContext::FbxNodeReaderContext(
 	UsdFbxDataReader& dataReader,
 	FbxNode* node,
 	SdfPath path,
 	FbxAnimLayer* animLayer,
 	FbxTimeSpan animTimeSpan,
-	double scaleFactor )
+	double scaleFactor,
+	FbxPropertyIndex& propertyIndex )
 	: m_dataReader( dataReader )
 	, m_fbxNode( node )
 	, m_usdPath( std::move( path ) )
 	, m_fbxAnimLayer( animLayer )
 	, m_fbxTimeSpan( std::move( animTimeSpan ) )
 	, m_scaleFactor( scaleFactor )
+	, m_propertyIndex( propertyIndex )
 {
 }
 
@@ -1743,7 +2091,11 @@ remedy::FbxNodeReaderContext::Property& remedy::FbxNodeReaderContext::CreateProp
 	prop.variability = variability;
 	if( fbxProperty != nullptr )
 	{
-		prop.timeSamples = helpers::getPropertyAnimation( GetNode(), *fbxProperty, GetAnimLayer(), GetAnimTimeSpan() );
+		prop.timeSamples = helpers::getPropertyAnimation(
+			*fbxProperty,
+			m_propertyIndex,
+			GetAnimTimeSpan(),
+			m_dataReader.GetCancelToken() );
 	}
 	prop.value = std::move( defaultValue );
 	return prop;
@@ -1778,7 +2130,12 @@ remedy::FbxNodeReaderContext::Property& remedy::FbxNodeReaderContext::CreateProp
 	prop.metadata = std::move( metadata );
 	prop.typeName = typeName;
 	prop.variability = variability;
-	prop.timeSamples = helpers::getPropertyAnimation( GetNode(), valueAtTimeFn, GetAnimLayer(), GetAnimTimeSpan() );
+	prop.timeSamples = helpers::getPropertyAnimation(
+		GetNode(),
+		valueAtTimeFn,
+		GetAnimLayer(),
+		GetAnimTimeSpan(),
+		m_dataReader.GetCancelToken() );
 	prop.value = std::move( defaultValue );
 	return prop;
 }
@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include "FbxPropertyIndex.h"
 #include "UsdFbxDataReader.h"
 
 #include <fbxsdk.h>
@@ -23,7 +24,8 @@ namespace remedy
 			SdfPath path,
 			FbxAnimLayer* animLayer,
 			FbxTimeSpan animTimeSpan,
-			double scaleFactor );
+			double scaleFactor,
+			FbxPropertyIndex& propertyIndex );
 
 		[[nodiscard]] double GetScaleFactor() const
 		{
@@ -61,6 +63,17 @@ namespace remedy
 			return m_fbxTimeSpan;
 		}
 
+		/// Returns the user defined and animated properties of the scene.
+		[[nodiscard]] FbxPropertyIndex& GetPropertyIndex()
+		{
+			return m_propertyIndex;
+		}
+
+		[[nodiscard]] const FbxPropertyIndex& GetPropertyIndex() const
+		{
+			return m_propertyIndex;
+		}
+
 		/// Returns the Usd path to this prim.
 		[[nodiscard]] const SdfPath& GetPath() const
 		{
@@ -106,6 +119,12 @@ namespace remedy
 			return m_dataReader;
 		}
 
+		/// Checkpoint for long running readers, see CancelToken.
+		[[nodiscard]] bool IsCancelled() const
+		{
+			return m_dataReader.GetCancelToken().IsCancelled();
+		}
+
 		Property& CreateProperty(
 			const SdfPath& propertyPath,
 			const SdfValueTypeName& typeName,
@@ -185,10 +204,15 @@ namespace remedy
 		FbxAnimLayer* m_fbxAnimLayer;
 		FbxTimeSpan m_fbxTimeSpan;
 		double m_scaleFactor;
+		FbxPropertyIndex& m_propertyIndex;
 	};
 
 	using NodeReaderFn = std::function< void( FbxNodeReaderContext& ) >;
 
+	/// Reads \p markers, the optical markers among the children of the context's
+	/// node, into a single Points prim at the context's path.
+	void ReadOpticalMarkers( FbxNodeReaderContext& context, const std::vector< FbxNode* >& markers );
+
 	class FbxNodeReaders
 	{
 	public:
@@ -0,0 +1,124 @@
+// Copyright (C) Remedy Entertainment Plc.
+
+#include "FbxPropertyIndex.h"
+
+#include "DebugCodes.h"
+#include "PrecompiledHeader.h"
+
+#include <pxr/base/trace/trace.h>
+
+#include <algorithm>
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+namespace
+{
+	// Nodes only have a handful of animated properties, a linear search beats hashing them
+	template< typename Container >
+	auto findProperty( Container& animated, const FbxProperty& property )
+	{
+		return std::find_if( animated.begin(), animated.end(), [ & ]( const auto& entry ) { return entry.first == property; } );
+	}
+} // namespace
+
+remedy::FbxPropertyIndex::FbxPropertyIndex( FbxAnimLayer* animLayer )
+	: m_animLayer( animLayer )
+{
+	if( m_animLayer == nullptr )
+	{
+		return;
+	}
+
+	TRACE_FUNCTION()
+	const int curveNodeCount = m_animLayer->GetMemberCount< FbxAnimCurveNode >();
+	for( int i = 0; i < curveNodeCount; ++i )
+	{
+		FbxAnimCurveNode* curveNode = m_animLayer->GetMember< FbxAnimCurveNode >( i );
+		for( int dst = 0, n = curveNode->GetDstPropertyCount(); dst < n; ++dst )
+		{
+			setCurveNode( curveNode->GetDstProperty( dst ), curveNode );
+		}
+	}
+	TF_DEBUG( USDFBX ).Msg( "UsdFbx - Indexed %d animation curve nodes over %zu objects\n", curveNodeCount, m_nodes.size() );
+}
+
+void remedy::FbxPropertyIndex::setCurveNode( const FbxProperty& property, FbxAnimCurveNode* curveNode )
+{
+	auto& animated = m_nodes[ property.GetFbxObject() ].animated;
+	const auto it = findProperty( animated, property );
+	if( it != animated.end() )
+	{
+		it->second = curveNode;
+	}
+	else if( curveNode != nullptr )
+	{
+		animated.emplace_back( property, curveNode );
+	}
+}
+
+FbxAnimCurveNode* remedy::FbxPropertyIndex::GetCurveNode( const FbxProperty& property ) const
+{
+	const auto nodeIt = m_nodes.find( property.GetFbxObject() );
+	if( nodeIt == m_nodes.end() )
+	{
+		return nullptr;
+	}
+
+	const auto& animated = nodeIt->second.animated;
+	const auto it = findProperty( animated, property );
+	return it != animated.end() ? it->second : nullptr;
+}
+
+const std::vector< FbxProperty >& remedy::FbxPropertyIndex::GetUserProperties( const FbxNode* node )
+{
+	auto& user = m_nodes[ node ].user;
+	if( !user )
+	{
+		TRACE_FUNCTION()
+		user.emplace();
+		for( FbxProperty property = node->GetFirstProperty(); property.IsValid(); property = node->GetNextProperty( property ) )
+		{
+			if( property.GetFlag( FbxPropertyFlags::EFlags::eUserDefined ) )
+			{
+				user->push_back( property );
+			}
+		}
+		TF_DEBUG( USDFBX_FBX_READERS )
+			.Msg( "UsdFbx::FbxReaders - Found %zu user defined properties on \"%s\"\n", user->size(), node->GetName() );
+	}
+	return *user;
+}
+
+std::vector< FbxProperty > remedy::FbxPropertyIndex::GetAnimatedUserProperties( const FbxNode* node )
+{
+	std::vector< FbxProperty > result;
+	for( const auto& property : GetUserProperties( node ) )
+	{
+		if( IsAnimated( property ) )
+		{
+			result.push_back( property );
+		}
+	}
+	return result;
+}
+
+void remedy::FbxPropertyIndex::RefreshTransform( FbxNode* node )
+{
+	if( m_animLayer == nullptr )
+	{
+		return;
+	}
+
+	for( FbxProperty* property : { static_cast< FbxProperty* >( &node->LclTranslation ),
+								   static_cast< FbxProperty* >( &node->LclRotation ),
+								   static_cast< FbxProperty* >( &node->LclScaling ),
+								   static_cast< FbxProperty* >( &node->RotationOffset ),
+								   static_cast< FbxProperty* >( &node->RotationPivot ),
+								   static_cast< FbxProperty* >( &node->ScalingOffset ),
+								   static_cast< FbxProperty* >( &node->ScalingPivot ),
+								   static_cast< FbxProperty* >( &node->PreRotation ),
+								   static_cast< FbxProperty* >( &node->PostRotation ) } )
+	{
+		setCurveNode( *property, property->GetCurveNode( m_animLayer ) );
+	}
+}
@@ -0,0 +1,62 @@
+// Copyright (C) Remedy Entertainment Plc.
+
+#pragma once
+
+#include <fbxsdk.h>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace remedy
+{
+	/// \class FbxPropertyIndex
+	///
+	/// Classifies the properties of a scene once, so that the readers do not have
+	/// to walk the full property list of every node, or ask every property for its
+	/// curve node, to find the few that are user defined or animated.
+	///
+	/// Animated properties are found up front from the destinations of the curve
+	/// nodes on the anim layer, at a cost that only depends on how much is animated.
+	/// The Fbx SDK has no such shortcut for user defined properties, they are looked
+	/// up once per node, the first time the readers ask for them, so nodes that are
+	/// never read are never scanned.
+	class FbxPropertyIndex
+	{
+	public:
+		explicit FbxPropertyIndex( FbxAnimLayer* animLayer );
+
+		FbxPropertyIndex( const FbxPropertyIndex& ) = delete;
+		void operator=( const FbxPropertyIndex& ) = delete;
+
+		/// Returns the curve node animating \p property on the anim layer, or nullptr.
+		[[nodiscard]] FbxAnimCurveNode* GetCurveNode( const FbxProperty& property ) const;
+
+		[[nodiscard]] bool IsAnimated( const FbxProperty& property ) const
+		{
+			return GetCurveNode( property ) != nullptr;
+		}
+
+		/// Returns the user defined properties of \p node.
+		[[nodiscard]] const std::vector< FbxProperty >& GetUserProperties( const FbxNode* node );
+
+		/// Returns the user defined properties of \p node that are animated.
+		[[nodiscard]] std::vector< FbxProperty > GetAnimatedUserProperties( const FbxNode* node );
+
+		/// Looks the transform properties of \p node up again, for after
+		/// FbxNode::ResetPivotSetAndConvertAnimation replaced their curves.
+		void RefreshTransform( FbxNode* node );
+
+	private:
+		struct NodeProperties
+		{
+			std::vector< std::pair< FbxProperty, FbxAnimCurveNode* > > animated;
+			std::optional< std::vector< FbxProperty > > user;
+		};
+
+		void setCurveNode( const FbxProperty& property, FbxAnimCurveNode* curveNode );
+
+		FbxAnimLayer* m_animLayer;
+		std::unordered_map< const FbxObject*, NodeProperties > m_nodes;
+	};
+} // namespace remedy
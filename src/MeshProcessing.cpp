@@ -0,0 +1,407 @@
+// Copyright (C) Remedy Entertainment Plc.
+
+#include "MeshProcessing.h"
+
+#include "PrecompiledHeader.h"
+
+#include <pxr/base/gf/vec3d.h>
+#include <pxr/base/trace/trace.h>
+
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+namespace
+{
+	// Faces whose area is this small relative to their squared perimeter are
+	// slivers that float points can not tell apart from a line
+	constexpr double MIN_RELATIVE_AREA = std::numeric_limits< float >::epsilon();
+
+	// Marks the corners of face [begin, end) to keep in keptCorners. Repeated
+	// consecutive points collapse into one corner, no corner is kept at all when
+	// the face is degenerate.
+	void keepCorners(
+		const VtVec3fArray& points,
+		const VtIntArray& faceVertexIndices,
+		size_t begin,
+		size_t end,
+		std::vector< GfVec3d >& corners,
+		std::vector< char >& keptCorners )
+	{
+		const int pointCount = static_cast< int >( points.size() );
+		int previous = -1;
+		size_t firstKept = end;
+		size_t lastKept = end;
+		corners.clear();
+		for( size_t corner = begin; corner < end; ++corner )
+		{
+			const int index = faceVertexIndices[ corner ];
+			if( index < 0 || index >= pointCount )
+			{
+				std::fill( keptCorners.begin() + begin, keptCorners.begin() + end, 0 );
+				return;
+			}
+			if( index != previous )
+			{
+				keptCorners[ corner ] = 1;
+				corners.emplace_back( points[ index ] );
+				firstKept = firstKept == end ? corner : firstKept;
+				lastKept = corner;
+				previous = index;
+			}
+		}
+
+		// The polygon is closed, its last corner may repeat the first one
+		if( corners.size() > 1 && faceVertexIndices[ lastKept ] == faceVertexIndices[ firstKept ] )
+		{
+			keptCorners[ lastKept ] = 0;
+			corners.pop_back();
+		}
+
+		// Twice the area, relative to the first corner so that meshes far away
+		// from the origin do not lose precision
+		GfVec3d normal( 0.0 );
+		double perimeter = 0.0;
+		for( size_t i = 0; i < corners.size(); ++i )
+		{
+			const GfVec3d& next = corners[ ( i + 1 ) % corners.size() ];
+			normal += GfCross( corners[ i ] - corners[ 0 ], next - corners[ 0 ] );
+			perimeter += ( next - corners[ i ] ).GetLength();
+		}
+
+		if( corners.size() < 3 || normal.GetLength() <= MIN_RELATIVE_AREA * perimeter * perimeter )
+		{
+			std::fill( keptCorners.begin() + begin, keptCorners.begin() + end, 0 );
+		}
+	}
+
+	// Tuning of the vertex scores, from the reference implementation of the paper
+	constexpr size_t VERTEX_CACHE_SIZE = 32;
+	constexpr float CACHE_DECAY_POWER = 1.5f;
+	constexpr float LAST_TRIANGLE_SCORE = 0.75f;
+	constexpr float VALENCE_BOOST_SCALE = 2.0f;
+	constexpr float VALENCE_BOOST_POWER = 0.5f;
+
+	float vertexScore( int cachePosition, int remainingTriangles )
+	{
+		if( remainingTriangles == 0 )
+		{
+			return -1.0f;
+		}
+
+		float score = 0.0f;
+		if( cachePosition >= 0 && cachePosition < 3 )
+		{
+			// The vertices of the last triangle are penalized a little, so that
+			// strips do not keep turning back on themselves
+			score = LAST_TRIANGLE_SCORE;
+		}
+		else if( cachePosition >= 3 )
+		{
+			const float scaler = 1.0f / static_cast< float >( VERTEX_CACHE_SIZE - 3 );
+			score = std::pow( 1.0f - static_cast< float >( cachePosition - 3 ) * scaler, CACHE_DECAY_POWER );
+		}
+
+		// Vertices with few triangles left are finished off first
+		return score + VALENCE_BOOST_SCALE * std::pow( static_cast< float >( remainingTriangles ), -VALENCE_BOOST_POWER );
+	}
+
+	// Returns the triangles of faceVertexIndices in the order to draw them
+	std::vector< int > optimizeTriangleOrder( size_t pointCount, const VtIntArray& faceVertexIndices )
+	{
+		const size_t triangleCount = faceVertexIndices.size() / 3;
+
+		// Triangles using every vertex, packed by vertex. The triangles still to
+		// be emitted come first in the range of a vertex.
+		std::vector< int > offsets( pointCount + 1, 0 );
+		for( const int index : faceVertexIndices )
+		{
+			++offsets[ index + 1 ];
+		}
+		std::vector< int > remaining( pointCount );
+		for( size_t vertex = 0; vertex < pointCount; ++vertex )
+		{
+			remaining[ vertex ] = offsets[ vertex + 1 ];
+		}
+		std::partial_sum( offsets.begin(), offsets.end(), offsets.begin() );
+
+		std::vector< int > vertexTriangles( faceVertexIndices.size() );
+		{
+			std::vector< int > cursors( offsets.begin(), offsets.end() - 1 );
+			for( size_t corner = 0; corner < faceVertexIndices.size(); ++corner )
+			{
+				vertexTriangles[ cursors[ faceVertexIndices[ corner ] ]++ ] = static_cast< int >( corner / 3 );
+			}
+		}
+
+		std::vector< int > cachePositions( pointCount, -1 );
+		std::vector< float > vertexScores( pointCount );
+		for( size_t vertex = 0; vertex < pointCount; ++vertex )
+		{
+			vertexScores[ vertex ] = vertexScore( -1, remaining[ vertex ] );
+		}
+
+		std::vector< float > triangleScores( triangleCount );
+		for( size_t triangle = 0; triangle < triangleCount; ++triangle )
+		{
+			triangleScores[ triangle ] = vertexScores[ faceVertexIndices[ triangle * 3 ] ]
+										 + vertexScores[ faceVertexIndices[ triangle * 3 + 1 ] ]
+										 + vertexScores[ faceVertexIndices[ triangle * 3 + 2 ] ];
+		}
+
+		std::vector< char > emitted( triangleCount, 0 );
+		std::vector< int > order;
+		order.reserve( triangleCount );
+
+		// The cache briefly holds the vertices of the new triangle on top of a full cache
+		std::vector< int > cache;
+		std::vector< int > nextCache;
+		cache.reserve( VERTEX_CACHE_SIZE + 3 );
+		nextCache.reserve( VERTEX_CACHE_SIZE + 3 );
+
+		int best = static_cast< int >(
+			std::max_element( triangleScores.begin(), triangleScores.end() ) - triangleScores.begin() );
+		size_t nextUnemitted = 0;
+		while( order.size() < triangleCount )
+		{
+			if( best < 0 )
+			{
+				// Nothing in the cache touches a triangle that is left, start over
+				// from the next one in the original order
+				while( emitted[ nextUnemitted ] )
+				{
+					++nextUnemitted;
+				}
+				best = static_cast< int >( nextUnemitted );
+			}
+
+			emitted[ best ] = 1;
+			order.push_back( best );
+
+			const int* triangle = faceVertexIndices.cdata() + best * 3;
+			nextCache.clear();
+			for( int i = 0; i < 3; ++i )
+			{
+				const int vertex = triangle[ i ];
+				if( std::find( nextCache.begin(), nextCache.end(), vertex ) == nextCache.end() )
+				{
+					nextCache.push_back( vertex );
+				}
+				int* begin = vertexTriangles.data() + offsets[ vertex ];
+				int* last = begin + --remaining[ vertex ];
+				std::iter_swap( std::find( begin, last + 1, best ), last );
+			}
+			for( const int vertex : cache )
+			{
+				if( vertex != triangle[ 0 ] && vertex != triangle[ 1 ] && vertex != triangle[ 2 ] )
+				{
+					nextCache.push_back( vertex );
+				}
+			}
+
+			// Rescore the vertices whose position changed, including those that just
+			// fell out of the cache, and the triangles they still have
+			for( size_t position = 0; position < nextCache.size(); ++position )
+			{
+				const int vertex = nextCache[ position ];
+				cachePositions[ vertex ] = position < VERTEX_CACHE_SIZE ? static_cast< int >( position ) : -1;
+				const float score = vertexScore( cachePositions[ vertex ], remaining[ vertex ] );
+				const float delta = score - vertexScores[ vertex ];
+				vertexScores[ vertex ] = score;
+				for( int i = offsets[ vertex ], end = offsets[ vertex ] + remaining[ vertex ]; i < end; ++i )
+				{
+					triangleScores[ vertexTriangles[ i ] ] += delta;
+				}
+			}
+			if( nextCache.size() > VERTEX_CACHE_SIZE )
+			{
+				nextCache.resize( VERTEX_CACHE_SIZE );
+			}
+			std::swap( cache, nextCache );
+
+			// The next triangle is the best one among those using a cached vertex
+			best = -1;
+			float bestScore = -std::numeric_limits< float >::max();
+			for( const int vertex : cache )
+			{
+				for( int i = offsets[ vertex ], end = offsets[ vertex ] + remaining[ vertex ]; i < end; ++i )
+				{
+					const int candidate = vertexTriangles[ i ];
+					if( triangleScores[ candidate ] > bestScore )
+					{
+						best = candidate;
+						bestScore = triangleScores[ candidate ];
+					}
+				}
+			}
+		}
+		return order;
+	}
+} // namespace
+
+remedy::MeshRemap::MeshRemap( size_t pointCount, const VtIntArray& faceVertexCounts, const VtIntArray& faceVertexIndices )
+	: m_sourcePointCount( pointCount )
+	, m_sourceFaceCount( faceVertexCounts.size() )
+	, m_sourceFaceVertexCount( faceVertexIndices.size() )
+	, m_faceVertexCounts( faceVertexCounts )
+	, m_faceVertexIndices( faceVertexIndices )
+{
+}
+
+remedy::MeshRemap remedy::MeshRemap::Clean(
+	const VtVec3fArray& points,
+	const VtIntArray& faceVertexCounts,
+	const VtIntArray& faceVertexIndices )
+{
+	TRACE_FUNCTION()
+	MeshRemap remap( points.size(), faceVertexCounts, faceVertexIndices );
+	const size_t faceCount = faceVertexCounts.size();
+	std::vector< size_t > faceStarts( faceCount + 1, 0 );
+	for( size_t face = 0; face < faceCount; ++face )
+	{
+		if( faceVertexCounts[ face ] < 0 )
+		{
+			return remap;
+		}
+		faceStarts[ face + 1 ] = faceStarts[ face ] + static_cast< size_t >( faceVertexCounts[ face ] );
+	}
+	if( faceStarts.back() != faceVertexIndices.size() )
+	{
+		return remap;
+	}
+
+	std::vector< char > keptCorners( faceVertexIndices.size(), 0 );
+	WorkParallelForN(
+		faceCount,
+		[ & ]( size_t begin, size_t end )
+		{
+			std::vector< GfVec3d > corners;
+			for( size_t face = begin; face < end; ++face )
+			{
+				keepCorners( points, faceVertexIndices, faceStarts[ face ], faceStarts[ face + 1 ], corners, keptCorners );
+			}
+		} );
+
+	// Compacting is sequential, it only walks the flags computed above
+	VtIntArray counts;
+	counts.reserve( faceCount );
+	std::vector< int > pointMap( points.size(), -1 );
+	std::vector< int > faceVertices;
+	faceVertices.reserve( faceVertexIndices.size() );
+	for( size_t face = 0; face < faceCount; ++face )
+	{
+		int count = 0;
+		for( size_t corner = faceStarts[ face ]; corner < faceStarts[ face + 1 ]; ++corner )
+		{
+			if( keptCorners[ corner ] )
+			{
+				faceVertices.push_back( static_cast< int >( corner ) );
+				pointMap[ faceVertexIndices[ corner ] ] = 0;
+				++count;
+			}
+		}
+
+		if( count > 0 )
+		{
+			counts.push_back( count );
+		}
+	}
+
+	std::vector< int > keptPoints;
+	keptPoints.reserve( points.size() );
+	for( size_t point = 0; point < points.size(); ++point )
+	{
+		if( pointMap[ point ] == 0 )
+		{
+			pointMap[ point ] = static_cast< int >( keptPoints.size() );
+			keptPoints.push_back( static_cast< int >( point ) );
+		}
+	}
+
+	if( faceVertices.size() == faceVertexIndices.size() && keptPoints.size() == points.size() )
+	{
+		return remap;
+	}
+
+	VtIntArray indices( faceVertices.size() );
+	int* remapped = indices.data();
+	WorkParallelForN(
+		faceVertices.size(),
+		[ & ]( size_t begin, size_t end )
+		{
+			for( size_t i = begin; i < end; ++i )
+			{
+				remapped[ i ] = pointMap[ faceVertexIndices[ faceVertices[ i ] ] ];
+			}
+		} );
+
+	remap.m_identity = false;
+	remap.m_points = std::move( keptPoints );
+	remap.m_faceVertices = std::move( faceVertices );
+	remap.m_faceVertexCounts = std::move( counts );
+	remap.m_faceVertexIndices = std::move( indices );
+	return remap;
+}
+
+remedy::MeshRemap remedy::MeshRemap::OptimizeVertexCache(
+	size_t pointCount,
+	const VtIntArray& faceVertexCounts,
+	const VtIntArray& faceVertexIndices )
+{
+	TRACE_FUNCTION()
+	MeshRemap remap( pointCount, faceVertexCounts, faceVertexIndices );
+	const bool isTriangulated = std::all_of(
+		faceVertexCounts.cbegin(),
+		faceVertexCounts.cend(),
+		[]( int count ) { return count == 3; } );
+	const bool isValid = std::all_of(
+		faceVertexIndices.cbegin(),
+		faceVertexIndices.cend(),
+		[ & ]( int index ) { return index >= 0 && static_cast< size_t >( index ) < pointCount; } );
+	if( faceVertexCounts.empty() || !isTriangulated || faceVertexIndices.size() != faceVertexCounts.size() * 3 || !isValid )
+	{
+		return remap;
+	}
+
+	const std::vector< int > triangles = optimizeTriangleOrder( pointCount, faceVertexIndices );
+
+	// Points are then stored in the order the triangles first use them, the ones
+	// no triangle uses go last
+	std::vector< int > pointMap( pointCount, -1 );
+	std::vector< int > points;
+	points.reserve( pointCount );
+	std::vector< int > faceVertices( faceVertexIndices.size() );
+	VtIntArray indices( faceVertexIndices.size() );
+	int* remapped = indices.data();
+	for( size_t i = 0; i < triangles.size(); ++i )
+	{
+		for( int corner = 0; corner < 3; ++corner )
+		{
+			const int faceVertex = triangles[ i ] * 3 + corner;
+			const int point = faceVertexIndices[ faceVertex ];
+			if( pointMap[ point ] < 0 )
+			{
+				pointMap[ point ] = static_cast< int >( points.size() );
+				points.push_back( point );
+			}
+			faceVertices[ i * 3 + corner ] = faceVertex;
+			remapped[ i * 3 + corner ] = pointMap[ point ];
+		}
+	}
+	for( size_t point = 0; point < pointCount; ++point )
+	{
+		if( pointMap[ point ] < 0 )
+		{
+			points.push_back( static_cast< int >( point ) );
+		}
+	}
+
+	remap.m_identity = false;
+	remap.m_points = std::move( points );
+	remap.m_faceVertices = std::move( faceVertices );
+	remap.m_faceVertexIndices = std::move( indices );
+	return remap;
+}
+
@@ -0,0 +1,140 @@
+// Copyright (C) Remedy Entertainment Plc.
+
+#pragma once
+
+#include <pxr/base/gf/vec3f.h>
+#include <pxr/base/tf/diagnostic.h>
+#include <pxr/base/vt/array.h>
+#include <pxr/base/vt/types.h>
+#include <pxr/base/work/loops.h>
+#include <pxr/pxr.h>
+
+#include <algorithm>
+#include <vector>
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+namespace remedy
+{
+	/// \class MeshRemap
+	///
+	/// A change to the topology of a mesh that keeps, drops or reorders its points
+	/// and face vertices.
+	///
+	/// The new topology is available from GetFaceVertexCounts() and
+	/// GetFaceVertexIndices(), the other arrays of the mesh are brought in line
+	/// with RemapVertices() for per point data (points, colors, joint influences)
+	/// and RemapFaceVertices() for face varying data (normals, tangents, uvs).
+	class MeshRemap
+	{
+	public:
+		/// Removes the degenerate faces of a mesh, faces left with less than three
+		/// corners once repeated consecutive points are collapsed or with no area,
+		/// and then the points that no remaining face references.
+		static MeshRemap
+		Clean( const VtVec3fArray& points, const VtIntArray& faceVertexCounts, const VtIntArray& faceVertexIndices );
+
+		/// Reorders the triangles of a mesh for the post-transform vertex cache of
+		/// GPUs (Forsyth, "Linear-Speed Vertex Cache Optimisation"), and then its
+		/// points in the order the triangles first use them. Meshes that are not
+		/// only made of triangles are left as they are.
+		static MeshRemap
+		OptimizeVertexCache( size_t pointCount, const VtIntArray& faceVertexCounts, const VtIntArray& faceVertexIndices );
+
+		/// Returns true when the mesh is left as it is.
+		[[nodiscard]] bool IsIdentity() const
+		{
+			return m_identity;
+		}
+
+		[[nodiscard]] size_t GetRemovedFaceCount() const
+		{
+			return m_identity ? 0 : m_sourceFaceCount - m_faceVertexCounts.size();
+		}
+
+		[[nodiscard]] size_t GetRemovedPointCount() const
+		{
+			return m_identity ? 0 : m_sourcePointCount - m_points.size();
+		}
+
+		[[nodiscard]] const VtIntArray& GetFaceVertexCounts() const
+		{
+			return m_faceVertexCounts;
+		}
+
+		[[nodiscard]] const VtIntArray& GetFaceVertexIndices() const
+		{
+			return m_faceVertexIndices;
+		}
+
+		/// Gathers the elements of the points that are kept, in their new order.
+		/// \p values holds \p elementSize elements per point. Arrays of any other
+		/// size cannot be remapped, they are dropped with a warning and an empty
+		/// array is returned, which callers must not author.
+		template< typename T >
+		VtArray< T > RemapVertices( const VtArray< T >& values, size_t elementSize = 1 ) const
+		{
+			return gather( values, m_points, m_sourcePointCount, elementSize, "points" );
+		}
+
+		/// Gathers the elements of the face vertices that are kept, in their new
+		/// order. Arrays of any other size than the original face vertex count are
+		/// dropped the way RemapVertices() drops them.
+		template< typename T >
+		VtArray< T > RemapFaceVertices( const VtArray< T >& values ) const
+		{
+			return gather( values, m_faceVertices, m_sourceFaceVertexCount, 1, "face vertices" );
+		}
+
+	private:
+		MeshRemap( size_t pointCount, const VtIntArray& faceVertexCounts, const VtIntArray& faceVertexIndices );
+
+		template< typename T >
+		VtArray< T > gather(
+			const VtArray< T >& values,
+			const std::vector< int >& sources,
+			size_t sourceCount,
+			size_t elementSize,
+			const char* sourceName ) const
+		{
+			if( m_identity || values.empty() )
+			{
+				return values;
+			}
+			if( values.size() != sourceCount * elementSize )
+			{
+				TF_WARN(
+					"Dropping an array of %zu elements, it does not have %zu elements for each of the %zu %s of its mesh",
+					values.size(),
+					elementSize,
+					sourceCount,
+					sourceName );
+				return {};
+			}
+
+			VtArray< T > result( sources.size() * elementSize );
+			const T* source = values.cdata();
+			T* destination = result.data();
+			WorkParallelForN(
+				sources.size(),
+				[ & ]( size_t begin, size_t end )
+				{
+					for( size_t i = begin; i < end; ++i )
+					{
+						std::copy_n( source + sources[ i ] * elementSize, elementSize, destination + i * elementSize );
+					}
+				} );
+			return result;
+		}
+
+		bool m_identity = true;
+		size_t m_sourcePointCount;
+		size_t m_sourceFaceCount;
+		size_t m_sourceFaceVertexCount;
+		// Original index of every point and face vertex that is kept, in their new order
+		std::vector< int > m_points;
+		std::vector< int > m_faceVertices;
+		VtIntArray m_faceVertexCounts;
+		VtIntArray m_faceVertexIndices;
+	};
+} // namespace remedy
@@ -8,5 +8,7 @@
 PXR_NAMESPACE_OPEN_SCOPE
 TF_DEFINE_PUBLIC_TOKENS( UsdFbxPrimTypeNames, USD_FBX_PRIM_TYPE_NAMES );
 TF_DEFINE_PUBLIC_TOKENS( UsdFbxDisplayGroupTokens, USD_FBX_DISPLAYGROUP_TOKENS );
+TF_DEFINE_PUBLIC_TOKENS( UsdFbxArgumentTokens, USD_FBX_ARGUMENT_TOKENS );
+TF_DEFINE_PUBLIC_TOKENS( UsdFbxLayerDataTokens, USD_FBX_LAYER_DATA_TOKENS );
 
 PXR_NAMESPACE_CLOSE_SCOPE
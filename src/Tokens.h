@@ -18,4 +18,14 @@ TF_DECLARE_PUBLIC_TOKENS( UsdFbxPrimTypeNames, USD_FBX_PRIM_TYPE_NAMES );
 		  "Generated" ) ) // For properties/prims that must be retained from FBX but have no default schema representation.
 TF_DECLARE_PUBLIC_TOKENS( UsdFbxDisplayGroupTokens, USD_FBX_DISPLAYGROUP_TOKENS );
 
+// File format arguments understood by the plugin, e.g. @asset.fbx:SDF_FORMAT_ARGS:timeout=5&onCancel=partial@
+#define USD_FBX_ARGUMENT_TOKENS                                                                                                  \
+	( timeout )( onCancel )( fail )( partial )( asciiFastPath )( precision )( full )( reduced )( cleanMeshes )(                \
+		optimizeVertexCache )( maxSubframes )( subframeLinearThreshold )( subframeAngularThreshold )
+TF_DECLARE_PUBLIC_TOKENS( UsdFbxArgumentTokens, USD_FBX_ARGUMENT_TOKENS );
+
+// Keys authored in the customLayerData of converted layers
+#define USD_FBX_LAYER_DATA_TOKENS ( ( partial, "usdFbx:partial" ) )
+TF_DECLARE_PUBLIC_TOKENS( UsdFbxLayerDataTokens, USD_FBX_LAYER_DATA_TOKENS );
+
 PXR_NAMESPACE_CLOSE_SCOPE
@@ -2,9 +2,11 @@
 
 #include "UsdFbxAbstractData.h"
 
+#include "ArrayStore.h"
 #include "DebugCodes.h"
 #include "PrecompiledHeader.h"
 #include "UsdFbxDataReader.h"
+#include "UsdFbxLayerCache.h"
 
 #include <pxr/base/tf/fileUtils.h>
 #include <pxr/base/trace/trace.h>
@@ -65,14 +67,37 @@ remedy::UsdFbxAbstractDataRefPtr remedy::UsdFbxAbstractData::New( SdfFileFormat:
 	return TfCreateRefPtr( new UsdFbxAbstractData( std::move( args ) ) );
 }
 
+remedy::UsdFbxAbstractDataRefPtr
+remedy::UsdFbxAbstractData::New( SdfFileFormat::FileFormatArguments args, std::shared_ptr< UsdFbxDataReader > reader )
+{
+	auto data = TfCreateRefPtr( new UsdFbxAbstractData( std::move( args ) ) );
+	data->m_reader = std::move( reader );
+	return data;
+}
+
 bool remedy::UsdFbxAbstractData::Open( const std::string& filePath )
 {
 	TfAutoMallocTag2 tag( "UsdFbxAbstractData", "UsdFbxAbstractData::Open" );
 	TRACE_FUNCTION()
 
-	m_reader.reset( new UsdFbxDataReader() );
+	// Arrays are shared here rather than in UsdFbxDataReader::Open, outside of the Fbx SDK lock
+	if( auto cachedReader = UsdFbxLayerCache::GetInstance().Take( filePath, m_arguments ) )
+	{
+		m_reader = std::move( cachedReader );
+		if( ArrayStore::IsEnabled() )
+		{
+			m_reader->ShareArrays();
+		}
+		return true;
+	}
+
+	m_reader = std::make_shared< UsdFbxDataReader >();
 	if( m_reader->Open( filePath, m_arguments ) )
 	{
+		if( ArrayStore::IsEnabled() )
+		{
+			m_reader->ShareArrays();
+		}
 		return true;
 	}
 
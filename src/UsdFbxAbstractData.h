@@ -5,10 +5,14 @@
 #include <pxr/usd/sdf/data.h>
 #include <pxr/usd/sdf/fileFormat.h>
 
+#include <memory>
+
 PXR_NAMESPACE_USING_DIRECTIVE
 
 namespace remedy
 {
+	class UsdFbxDataReader;
+
 	TF_DECLARE_WEAK_AND_REF_PTRS( UsdFbxAbstractData );
 
 	/// \class UsdFbxAbstractData
@@ -20,10 +24,21 @@ namespace remedy
 	public:
 		static UsdFbxAbstractDataRefPtr New( SdfFileFormat::FileFormatArguments = {} );
 
+		/// Returns data that reads from \p reader, which is already open. The
+		/// converted data is never modified, several layers can share it.
+		static UsdFbxAbstractDataRefPtr
+		New( SdfFileFormat::FileFormatArguments args, std::shared_ptr< UsdFbxDataReader > reader );
+
 		bool Open( const std::string& filePath );
 
 		void Close();
 
+		/// Returns the reader the data comes from, nullptr until Open() succeeded.
+		[[nodiscard]] const std::shared_ptr< UsdFbxDataReader >& GetReader() const
+		{
+			return m_reader;
+		}
+
 		bool StreamsData() const override;
 		void CreateSpec( const SdfPath&, SdfSpecType specType ) override;
 		bool HasSpec( const SdfPath& ) const override;
@@ -61,7 +76,7 @@ namespace remedy
 		void _VisitSpecs( SdfAbstractDataSpecVisitor* visitor ) const override;
 
 	private:
-		std::unique_ptr< class UsdFbxDataReader > m_reader;
+		std::shared_ptr< UsdFbxDataReader > m_reader;
 
 		// Currently unused, but will be helpful in the future
 		const SdfFileFormat::FileFormatArguments m_arguments;
@@ -2,17 +2,27 @@
 
 #include "UsdFbxDataReader.h"
 
+#include "ArrayStore.h"
+#include "AsciiFbxReader.h"
+#include "CompressedFbxStream.h"
 #include "DebugCodes.h"
 #include "Error.h"
+#include "FbxGlobals.h"
 #include "FbxNodeReader.h"
 #include "Helpers.h"
 #include "PrecompiledHeader.h"
 #include "Tokens.h"
 
+#include <algorithm>
+#include <cstdlib>
 #include <fbxsdk.h>
 #include <fbxsdk/core/fbxsystemunit.h>
 #include <filesystem>
+#include <memory>
+#include <pxr/base/tf/envSetting.h>
+#include <pxr/base/tf/stringUtils.h>
 #include <pxr/base/trace/trace.h>
+#include <pxr/base/vt/dictionary.h>
 #include <pxr/usd/kind/registry.h>
 #include <pxr/usd/sdf/schema.h>
 #include <pxr/usd/usd/tokens.h>
@@ -22,61 +32,73 @@
 
 PXR_NAMESPACE_USING_DIRECTIVE
 
-std::mutex mutex;
-using namespace std::chrono_literals;
+TF_DEFINE_ENV_SETTING(
+	USDFBX_ASCII_FAST_PATH,
+	false,
+	"Opt in to parsing the geometry of ASCII Fbx files ahead of the Fbx SDK import, the asciiFastPath argument takes precedence" );
+
+#ifdef USDFBX_TEST_HOOKS
+// Only compiled into USDFBX_BUILD_TESTS builds, where it lets the tests cancel a conversion at a given point
+TF_DEFINE_ENV_SETTING(
+	USDFBX_CANCEL_AFTER_CHECKPOINTS,
+	0,
+	"Cancels every conversion after this many cancellation checkpoints, 0 disables it. Used to test partial layers" );
+#endif
 
 namespace
 {
-	class FbxGlobals
-	{
-	public:
-		static FbxGlobals& getInstance()
-		{
-			static FbxGlobals instance;
-			return instance;
-		}
+	// More subframes than this would sample faster than any shutter needs
+	constexpr int MAX_SUBFRAMES = 64;
 
-		FbxManager* getManager() const
-		{
-			return m_fbxManager.get();
-		}
-
-	private:
-		FbxGlobals()
-		{
-			m_fbxManager.reset( FbxManager::Create() );
-		}
-
-		remedy::FbxPtr< FbxManager > m_fbxManager;
+	// Returning false from the progress callback aborts FbxImporter::Import
+	bool importProgressCallback( void* args, float, const char* )
+	{
+		return !static_cast< const remedy::CancelToken* >( args )->IsCancelled();
+	}
 
-	public:
-		FbxGlobals( const FbxGlobals& ) = delete;
-		void operator=( const FbxGlobals& ) = delete;
+	// What importFbxScene hands to the Fbx SDK, in order of precedence
+	struct ImportSource
+	{
+		// The stripped copy it wrote is imported, the parsed arrays are moved into the scene afterwards
+		const remedy::AsciiFbxReader* asciiReader = nullptr;
+		// Decompresses a binary Fbx file while it is being imported
+		remedy::CompressedFbxStream* stream = nullptr;
+		// Uncompressed file, either the opened file or its spooled decompressed copy
+		std::string filePath;
 	};
 
-	std::tuple< FbxManager*, remedy::FbxPtr< FbxScene > > importFbxScene( const std::string& filePath )
+	std::tuple< FbxManager*, remedy::FbxPtr< FbxScene > > importFbxScene(
+		const std::string& filePath,
+		const ImportSource& source,
+		const remedy::CancelToken& cancelToken )
 	{
-		auto fbxSdkManager = FbxGlobals::getInstance().getManager();
-		const auto pIOSettings = remedy::FbxPtr< FbxIOSettings >( FbxIOSettings::Create( fbxSdkManager, IOSROOT ) );
+		auto& globals = remedy::FbxGlobals::getInstance();
+		auto fbxSdkManager = globals.getManager();
+		const auto ioSettings = globals.acquireIOSettings();
 		auto scene = remedy::FbxPtr< FbxScene >( FbxScene::Create( fbxSdkManager, filePath.c_str() ) );
 		auto importer = remedy::FbxPtr< FbxImporter >( FbxImporter::Create( fbxSdkManager, "" ) );
 
-		pIOSettings->SetBoolProp( IMP_FBX_MATERIAL, true );
-		pIOSettings->SetBoolProp( IMP_FBX_TEXTURE, true );
-		pIOSettings->SetBoolProp( IMP_FBX_LINK, true );
-		pIOSettings->SetBoolProp( IMP_FBX_SHAPE, true );
-		pIOSettings->SetBoolProp( IMP_FBX_GOBO, true );
-		pIOSettings->SetBoolProp( IMP_FBX_ANIMATION, true );
-		pIOSettings->SetBoolProp( IMP_FBX_GLOBAL_SETTINGS, true );
-		fbxSdkManager->SetIOSettings( pIOSettings.get() );
-
 		TF_DEBUG( USDFBX ).Msg( "UsdFbx - Opening \"%s\"\n", filePath.c_str() );
 
 		int sdkMajor, sdkMinor, sdkRevision;
 		FbxManager::GetFileFormatVersion( sdkMajor, sdkMinor, sdkRevision );
 		TF_DEBUG( USDFBX ).Msg( "UsdFbx - Fbx version (%d.%d.%d)\n", sdkMajor, sdkMinor, sdkRevision );
 
-		const bool bImportStatus = importer->Initialize( filePath.c_str() );
+		bool bImportStatus = false;
+		if( source.asciiReader )
+		{
+			bImportStatus = importer->Initialize( source.asciiReader->GetStrippedFilePath().c_str(), -1, ioSettings.get() );
+		}
+		else if( source.stream )
+		{
+			const int readerId = fbxSdkManager->GetIOPluginRegistry()->FindReaderIDByDescription( "FBX binary (*.fbx)" );
+			source.stream->SetReaderID( readerId );
+			bImportStatus = importer->Initialize( source.stream, nullptr, readerId, ioSettings.get() );
+		}
+		else
+		{
+			bImportStatus = importer->Initialize( source.filePath.c_str(), -1, ioSettings.get() );
+		}
 		if( !bImportStatus )
 		{
 			TF_ERROR( UsdFbxError::FBX_UNABLE_TO_OPEN, "[x] FBX import failed! Unable to initialize FbxImporter\n" );
@@ -102,13 +124,34 @@ namespace
 			return { nullptr, nullptr };
 		}
 
+		importer->SetProgressCallback( importProgressCallback, const_cast< remedy::CancelToken* >( &cancelToken ) );
 		const bool success = importer->Import( scene.get() );
+		if( !success && cancelToken.WasCancelled() )
+		{
+			// Reported by the caller
+			return { nullptr, nullptr };
+		}
 		if( !success )
 		{
 			TF_ERROR( UsdFbxError::FBX_UNABLE_TO_OPEN, "[x] FBX import failed!\n" );
 
 			return { nullptr, nullptr };
 		}
+
+		// The importer may get by with what was read before a truncated file ended
+		if( source.stream && source.stream->HasFailed() )
+		{
+			TF_ERROR( UsdFbxError::FBX_UNABLE_TO_OPEN, "[x] FBX import failed! The compressed file is truncated or corrupt\n" );
+			return { nullptr, nullptr };
+		}
+
+		if( source.asciiReader && !source.asciiReader->Apply( scene.get() ) )
+		{
+			TF_DEBUG( USDFBX ).Msg( "UsdFbx - ASCII fast path does not match the imported scene, importing again\n" );
+			ImportSource original = source;
+			original.asciiReader = nullptr;
+			return importFbxScene( filePath, original, cancelToken );
+		}
 		return { fbxSdkManager, std::move( scene ) };
 	}
 
@@ -331,6 +374,76 @@ namespace
 		return _fbxNodeReaders.Get( attributeType );
 	}
 
+	// Motion capture files hold hundreds of optical markers, the markers under a
+	// given node are converted into a single Points prim instead of one Xform each
+	void collectOpticalMarkers(
+		remedy::UsdFbxDataReader& context,
+		FbxNode* node,
+		const SdfPath& nodePath,
+		remedy::UsdFbxDataReader::Prim& prim,
+		FbxAnimLayer* animLayer,
+		FbxTimeSpan animTimeSpan,
+		const double scaleFactor,
+		remedy::FbxPropertyIndex& propertyIndex )
+	{
+		std::vector< FbxNode* > markers;
+		for( int i = 0, n = node->GetChildCount(); i != n; ++i )
+		{
+			FbxNode* child = node->GetChild( i );
+			const auto* attr = child->GetNodeAttribute();
+			if( attr != nullptr && attr->GetAttributeType() == FbxNodeAttribute::eOpticalMarker )
+			{
+				markers.push_back( child );
+				// A point has nowhere to put children, and Gprims are not meant to be nested anyway
+				if( child->GetChildCount() > 0 )
+				{
+					TF_WARN(
+						"Optical marker \"%s\" has %d children, they are not converted",
+						child->GetName(),
+						child->GetChildCount() );
+				}
+			}
+		}
+
+		if( markers.empty() || context.GetCancelToken().IsCancelled() )
+		{
+			return;
+		}
+
+		// Collected once the other children are read, so that the name is checked
+		// against the sanitized names they were given
+		const auto isUsed = [ & ]( const std::string& name )
+		{ return std::find( prim.children.begin(), prim.children.end(), TfToken( name ) ) != prim.children.end(); };
+		std::string name = "opticalMarkers";
+		for( int suffix = 1; isUsed( name ); ++suffix )
+		{
+			name = TfStringPrintf( "opticalMarkers_%d", suffix );
+		}
+
+		prim.children.push_back( TfToken( name ) );
+		const SdfPath markersPath = nodePath.AppendChild( TfToken( name ) );
+		remedy::FbxNodeReaderContext
+			markersContext( context, node, markersPath, animLayer, animTimeSpan, scaleFactor, propertyIndex );
+		remedy::ReadOpticalMarkers( markersContext, markers );
+	}
+
+	// The skeleton readers only convert joints, whatever else hangs below a skeleton is lost
+	int countOpticalMarkers( FbxNode* node )
+	{
+		int count = 0;
+		for( int i = 0, n = node->GetChildCount(); i != n; ++i )
+		{
+			FbxNode* child = node->GetChild( i );
+			const auto* attr = child->GetNodeAttribute();
+			if( attr != nullptr && attr->GetAttributeType() == FbxNodeAttribute::eOpticalMarker )
+			{
+				++count;
+			}
+			count += countOpticalMarkers( child );
+		}
+		return count;
+	}
+
 	void collectFbxNodes(
 		remedy::UsdFbxDataReader& context,
 		FbxNode* node,
@@ -338,8 +451,18 @@ namespace
 		remedy::UsdFbxDataReader::Prim& parentPrim,
 		FbxAnimLayer* animLayer,
 		FbxTimeSpan animTimeSpan,
-		const double scaleFactor )
+		const double scaleFactor,
+		remedy::FbxPropertyIndex& propertyIndex,
+		const bool keepPartial )
 	{
+		// Once cancelled, either stop right away or keep walking the hierarchy, in
+		// which case the readers skip their expensive parts (geometry, animation)
+		const remedy::CancelToken& cancelToken = context.GetCancelToken();
+		if( !keepPartial && cancelToken.IsCancelled() )
+		{
+			return;
+		}
+
 		// We bail out when we encounter an FBXNode that has not attribute pointer
 		// (very rare) but is also not covered by a reader. Usd _demands_ that any
 		// prim has at least one spec, the readers give it the specs needed
@@ -349,6 +472,12 @@ namespace
 			return;
 		}
 
+		// Read in batches by collectOpticalMarkers
+		if( attr->GetAttributeType() == FbxNodeAttribute::eOpticalMarker )
+		{
+			return;
+		}
+
 		const auto readers = getFbxNodeReaders( attr->GetAttributeType() );
 		if( readers.empty() )
 		{
@@ -374,27 +503,77 @@ namespace
 		}
 
 		const SdfPath nodePath = parentPath.AppendChild( TfToken( name ) );
-		remedy::FbxNodeReaderContext primContext( context, node, nodePath, animLayer, animTimeSpan, scaleFactor );
-		for( const auto& reader : readers )
+		remedy::FbxNodeReaderContext primContext( context, node, nodePath, animLayer, animTimeSpan, scaleFactor, propertyIndex );
+
+		// Returns the prim of the node, or nothing when its readers created the prims
+		// themselves (skeletons) or the open got cancelled
+		const auto readNode = [ & ]() -> remedy::UsdFbxDataReader::Prim*
 		{
-			reader( primContext );
+			for( const auto& reader : readers )
+			{
+				if( !keepPartial && cancelToken.IsCancelled() )
+				{
+					return nullptr;
+				}
+				reader( primContext );
+			}
+
+			// Special case for dealing with skeletal data due to how Usd skeletons are
+			// supposed to look. We halt here and assume the reader has created the
+			// correct prims for us
+			if( node->GetNodeAttribute()->GetAttributeType() == FbxNodeAttribute::eSkeleton )
+			{
+				return nullptr;
+			}
+
+			parentPrim.children.push_back( TfToken( name ) );
+			return &context.AddPrim( nodePath );
+		};
+
+		const size_t parentChildCount = parentPrim.children.size();
+		const bool wasCancelled = keepPartial && cancelToken.IsCancelled();
+		remedy::UsdFbxDataReader::Prim* newPrim = readNode();
+
+		// A cancellation in the middle of the readers leaves their prims half read,
+		// a mesh can have its topology without its primvars. Those prims are dropped
+		// and read again the way every node after the cancellation is.
+		if( keepPartial && !wasCancelled && cancelToken.WasCancelled() )
+		{
+			TF_DEBUG( USDFBX ).Msg( "UsdFbx - Dropping the unfinished prims of <%s>\n", nodePath.GetText() );
+			for( size_t i = parentChildCount; i < parentPrim.children.size(); ++i )
+			{
+				context.RemovePrim( parentPath.AppendChild( parentPrim.children[ i ] ) );
+			}
+			parentPrim.children.resize( parentChildCount );
+			context.RemovePrim( nodePath );
+			newPrim = readNode();
 		}
 
-		// Special case for dealing with skeletal data due to how Usd skeletons are
-		// supposed to look. We halt here and assume the reader has created the
-		// correct prims for us
-		if( node->GetNodeAttribute()->GetAttributeType() == FbxNodeAttribute::eSkeleton )
+		if( newPrim == nullptr )
 		{
+			const int markerCount = attr->GetAttributeType() == FbxNodeAttribute::eSkeleton ? countOpticalMarkers( node ) : 0;
+			if( markerCount > 0 )
+			{
+				TF_WARN( "%d optical markers under skeleton \"%s\" are not converted", markerCount, node->GetName() );
+			}
 			return;
 		}
 
-		parentPrim.children.push_back( TfToken( name ) );
-		remedy::UsdFbxDataReader::Prim& newPrim = context.AddPrim( nodePath );
 		for( size_t i = 0, n = node->GetChildCount(); i != n; ++i )
 		{
 			FbxNode* child = node->GetChild( static_cast< int >( i ) );
-			collectFbxNodes( context, child, nodePath, newPrim, animLayer, animTimeSpan, scaleFactor );
+			collectFbxNodes(
+				context,
+				child,
+				nodePath,
+				*newPrim,
+				animLayer,
+				animTimeSpan,
+				scaleFactor,
+				propertyIndex,
+				keepPartial );
 		}
+		collectOpticalMarkers( context, node, nodePath, *newPrim, animLayer, animTimeSpan, scaleFactor, propertyIndex );
 	}
 
 	void bakeAnimationLayers( FbxScene* scene, FbxAnimStack* animStack )
@@ -473,18 +652,180 @@ namespace
 			frontVectorSign < 0 ? '-' : '+',
 			axisStringMap.at( frontVectorAxisID ) );
 	}
+
+	bool useAsciiFastPath( const SdfFileFormat::FileFormatArguments& args )
+	{
+		const auto it = args.find( UsdFbxArgumentTokens->asciiFastPath );
+		if( it == args.end() )
+		{
+			return TfGetEnvSetting( USDFBX_ASCII_FAST_PATH );
+		}
+		return it->second == "1" || TfStringToLower( it->second ) == "true";
+	}
+
+	remedy::UsdFbxDataReader::Options readOptions( const SdfFileFormat::FileFormatArguments& args )
+	{
+		remedy::UsdFbxDataReader::Options options;
+		const auto precisionIt = args.find( UsdFbxArgumentTokens->precision );
+		if( precisionIt != args.end() )
+		{
+			options.reducedPrecision = precisionIt->second == UsdFbxArgumentTokens->reduced;
+			if( !options.reducedPrecision && precisionIt->second != UsdFbxArgumentTokens->full )
+			{
+				TF_WARN(
+					"Ignoring invalid usdFbx precision \"%s\", expected \"%s\" or \"%s\"",
+					precisionIt->second.c_str(),
+					UsdFbxArgumentTokens->full.GetText(),
+					UsdFbxArgumentTokens->reduced.GetText() );
+			}
+		}
+
+		const auto readFlag = [ & ]( const TfToken& name, bool& flag )
+		{
+			const auto it = args.find( name );
+			if( it != args.end() )
+			{
+				flag = it->second == "1" || TfStringToLower( it->second ) == "true";
+			}
+		};
+		readFlag( UsdFbxArgumentTokens->cleanMeshes, options.cleanMeshes );
+		readFlag( UsdFbxArgumentTokens->optimizeVertexCache, options.optimizeVertexCache );
+
+		// Numbers must be strictly positive, or not negative when zero is allowed.
+		// Invalid values keep the default
+		const auto readNumber = [ & ]( const TfToken& name, double& number, const bool allowZero )
+		{
+			const auto it = args.find( name );
+			if( it == args.end() )
+			{
+				return;
+			}
+			char* end = nullptr;
+			const double value = std::strtod( it->second.c_str(), &end );
+			if( end == it->second.c_str() || *end != '\0' || !( allowZero ? value >= 0.0 : value > 0.0 ) )
+			{
+				TF_WARN(
+					"Ignoring invalid usdFbx %s \"%s\", expected a %s number",
+					name.GetText(),
+					it->second.c_str(),
+					allowZero ? "non-negative" : "positive" );
+				return;
+			}
+			number = value;
+		};
+		// Zero, the default, disables subframes
+		double maxSubframes = options.maxSubframes;
+		readNumber( UsdFbxArgumentTokens->maxSubframes, maxSubframes, true );
+		options.maxSubframes = static_cast< int >( std::min( maxSubframes, static_cast< double >( MAX_SUBFRAMES ) ) );
+		readNumber( UsdFbxArgumentTokens->subframeLinearThreshold, options.subframeLinearThreshold, false );
+		readNumber( UsdFbxArgumentTokens->subframeAngularThreshold, options.subframeAngularThreshold, false );
+		return options;
+	}
+
+	// Reads the timeout and onCancel arguments, returns whether a partial layer
+	// should be kept when the open gets cancelled.
+	bool applyCancelArguments( const SdfFileFormat::FileFormatArguments& args, remedy::CancelToken& cancelToken )
+	{
+		const auto timeoutIt = args.find( UsdFbxArgumentTokens->timeout );
+		if( timeoutIt != args.end() )
+		{
+			char* end = nullptr;
+			const double seconds = std::strtod( timeoutIt->second.c_str(), &end );
+			if( end == timeoutIt->second.c_str() || *end != '\0' || seconds < 0.0 )
+			{
+				TF_WARN( "Ignoring invalid usdFbx timeout \"%s\", expected a number of seconds", timeoutIt->second.c_str() );
+			}
+			else
+			{
+				cancelToken.SetTimeout( seconds );
+			}
+		}
+
+		const auto onCancelIt = args.find( UsdFbxArgumentTokens->onCancel );
+		if( onCancelIt == args.end() || onCancelIt->second == UsdFbxArgumentTokens->fail )
+		{
+			return false;
+		}
+		if( onCancelIt->second == UsdFbxArgumentTokens->partial )
+		{
+			return true;
+		}
+		TF_WARN(
+			"Ignoring invalid usdFbx onCancel \"%s\", expected \"%s\" or \"%s\"",
+			onCancelIt->second.c_str(),
+			UsdFbxArgumentTokens->fail.GetText(),
+			UsdFbxArgumentTokens->partial.GetText() );
+		return false;
+	}
 } // namespace
 
 bool remedy::UsdFbxDataReader::Open( const std::string& filePath, const SdfFileFormat::FileFormatArguments& args )
 {
 	TRACE_FUNCTION()
+	const std::string fileName = std::filesystem::path( filePath ).filename().generic_string();
+
+	// The timeout starts before waiting on the SDK lock, time spent queued behind
+	// other opens counts towards it.
+	const bool keepPartial = applyCancelArguments( args, m_cancelToken );
+	m_options = readOptions( args );
+	const ScopedCancelRegistration cancelRegistration( filePath, m_cancelToken );
+
+	ImportSource source;
+	source.filePath = filePath;
+
+	// Compressed binary files are decompressed by the import as it reads them. The
+	// Fbx SDK does not read ASCII files from streams, those are decompressed to a
+	// temporary file instead, before taking the lock.
+	std::unique_ptr< CompressedFbxStream > compressedStream;
+	const FbxCompression compression = GetFbxCompression( filePath );
+	if( compression != FbxCompression::None )
+	{
+		compressedStream = std::make_unique< CompressedFbxStream >( filePath, compression );
+		if( compressedStream->IsBinaryFbx() )
+		{
+			source.stream = compressedStream.get();
+		}
+		else
+		{
+			source.filePath = compressedStream->Spool( m_cancelToken );
+			if( source.filePath.empty() && !m_cancelToken.WasCancelled() )
+			{
+				TF_ERROR( UsdFbxError::FBX_UNABLE_TO_OPEN, "%s: Unable to decompress the Fbx file\n", fileName.c_str() );
+				return false;
+			}
+		}
+	}
+
+	// The ASCII fast path parses the file without the Fbx SDK, so it runs before
+	// taking the lock and concurrently with other opens.
+	AsciiFbxReader asciiReader;
+	if( !source.stream && !source.filePath.empty() && useAsciiFastPath( args ) && AsciiFbxReader::IsAsciiFbx( source.filePath )
+		&& asciiReader.Parse( source.filePath, m_cancelToken ) )
+	{
+		source.asciiReader = &asciiReader;
+	}
+
 	// Warning: importFbxScene _has_ to lock to prevent multithreaded access to
 	// the underlying FbxManager.
-	std::lock_guard lock( mutex );
+	std::lock_guard lock( FbxGlobals::getInstance().getMutex() );
 
 	FbxManager* fbxManager = nullptr;
 	FbxPtr< FbxScene > scene = nullptr;
-	std::tie( fbxManager, scene ) = importFbxScene( filePath );
+	if( !m_cancelToken.IsCancelled() )
+	{
+		std::tie( fbxManager, scene ) = importFbxScene( filePath, source, m_cancelToken );
+	}
+
+	// Nothing to salvage from a cancelled import, regardless of keepPartial
+	if( !scene && m_cancelToken.WasCancelled() )
+	{
+		TF_ERROR(
+			UsdFbxError::USDFBX_OPEN_CANCELLED,
+			"%s: Fbx import %s",
+			fileName.c_str(),
+			m_cancelToken.HasTimedOut() ? "timed out" : "was cancelled" );
+		return false;
+	}
 
 	if( !scene )
 	{
@@ -492,7 +833,13 @@ bool remedy::UsdFbxDataReader::Open( const std::string& filePath, const SdfFileF
 		return false;
 	}
 
-	const std::string fileName = std::filesystem::path( filePath ).filename().generic_string();
+#ifdef USDFBX_TEST_HOOKS
+	// Only the checkpoints of the conversion count, the import polls the token at a rate of its own
+	if( const int checkpoints = TfGetEnvSetting( USDFBX_CANCEL_AFTER_CHECKPOINTS ); checkpoints > 0 )
+	{
+		m_cancelToken.SetCheckpointBudget( checkpoints );
+	}
+#endif
 
 	// Checking and logging mismatching Axis and Units first. The scene will be
 	// converted to support USD natively (Y-up/RH/0.01m per unit)
@@ -640,9 +987,34 @@ bool remedy::UsdFbxDataReader::Open( const std::string& filePath, const SdfFileF
 		newPrim.metadata.emplace( UsdTokens->apiSchemas, VtValue( SdfTokenListOp::Create( { TfToken( "SkelBindingAPI" ) } ) ) );
 	}
 
+	FbxPropertyIndex propertyIndex( animLayer );
 	for( int childId = 0; childId < root->GetChildCount(); ++childId )
 	{
-		collectFbxNodes( *this, root->GetChild( childId ), nodePath, newPrim, animLayer, animTimeSpan, conversionFactorToCm );
+		collectFbxNodes(
+			*this,
+			root->GetChild( childId ),
+			nodePath,
+			newPrim,
+			animLayer,
+			animTimeSpan,
+			conversionFactorToCm,
+			propertyIndex,
+			keepPartial );
+	}
+	collectOpticalMarkers( *this, root, nodePath, newPrim, animLayer, animTimeSpan, conversionFactorToCm, propertyIndex );
+
+	if( m_cancelToken.WasCancelled() )
+	{
+		const char* reason = m_cancelToken.HasTimedOut() ? "timed out" : "was cancelled";
+		if( !keepPartial )
+		{
+			TF_ERROR( UsdFbxError::USDFBX_OPEN_CANCELLED, "%s: Fbx conversion %s", fileName.c_str(), reason );
+			return false;
+		}
+
+		TF_WARN( "%s: Fbx conversion %s, the layer only holds the hierarchy and transforms", fileName.c_str(), reason );
+		m_pseudoRoot->metadata[ SdfFieldKeys->CustomLayerData ]
+			= VtValue( VtDictionary{ { UsdFbxLayerDataTokens->partial.GetString(), VtValue( true ) } } );
 	}
 
 	if( !m_pseudoRoot->children.empty() )
@@ -654,6 +1026,24 @@ bool remedy::UsdFbxDataReader::Open( const std::string& filePath, const SdfFileF
 	return true;
 }
 
+void remedy::UsdFbxDataReader::ShareArrays()
+{
+	TRACE_FUNCTION()
+	ArrayStore& store = ArrayStore::GetInstance();
+	for( auto& [ primPath, prim ] : m_prims )
+	{
+		for( auto& [ propertyPath, property ] : prim.propertiesCache )
+		{
+			store.Share( property.value );
+			for( auto& [ time, value ] : property.timeSamples )
+			{
+				store.Share( value );
+			}
+		}
+	}
+	TF_DEBUG( USDFBX ).Msg( "UsdFbx - %zu arrays are shared between the open Fbx layers\n", store.GetSize() );
+}
+
 std::string remedy::UsdFbxDataReader::GetErrors() const
 {
 	return m_errorLog;
@@ -862,6 +1252,16 @@ remedy::UsdFbxDataReader::Prim& remedy::UsdFbxDataReader::AddPrim( const SdfPath
 	return ptr.first->second;
 }
 
+void remedy::UsdFbxDataReader::RemovePrim( const SdfPath& path )
+{
+	// Paths sort before their descendants, which follow them in the map
+	auto it = m_prims.lower_bound( path );
+	while( it != m_prims.end() && it->first.HasPrefix( path ) )
+	{
+		it = m_prims.erase( it );
+	}
+}
+
 std::optional< const remedy::UsdFbxDataReader::Prim* > remedy::UsdFbxDataReader::GetPrim( const SdfPath& path ) const
 {
 	const auto it = m_prims.find( path.IsAbsoluteRootPath() ? path : path.GetPrimPath() );
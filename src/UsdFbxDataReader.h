@@ -2,6 +2,8 @@
 
 #pragma once
 
+#include "CancelToken.h"
+
 #include <pxr/base/tf/token.h>
 #include <pxr/pxr.h>
 #include <pxr/usd/sdf/abstractData.h>
@@ -78,6 +80,32 @@ namespace remedy
 			SdfPath prototype; // Path to prototype; only set on instances, currently unused
 		};
 
+		/// Conversion settings read from the file format arguments.
+		struct Options
+		{
+			/// Normals, tangents and uvs are authored as halfs, static translations
+			/// and pivots as floats. Points always keep their full precision.
+			bool reducedPrecision = false;
+
+			/// Degenerate faces, and the points no face references, are removed from meshes.
+			bool cleanMeshes = false;
+
+			/// The triangles of triangulated meshes are reordered for the GPU vertex
+			/// cache, and their points in the order the triangles use them.
+			bool optimizeVertexCache = false;
+
+			/// Up to this many subframe samples are added between two frames of a
+			/// transform or skeleton that moves faster than the thresholds below.
+			/// 0 samples every frame only.
+			int maxSubframes = 0;
+
+			/// Distance, in scene units per frame, above which subframes are added.
+			double subframeLinearThreshold = 10.0;
+
+			/// Rotation, in degrees per frame, above which subframes are added.
+			double subframeAngularThreshold = 15.0;
+		};
+
 		// Basic interface with UsdSdfAbstractData
 		UsdFbxDataReader() = default;
 		~UsdFbxDataReader() = default;
@@ -124,6 +152,8 @@ namespace remedy
 		// ------
 
 		Prim& AddPrim( const SdfPath& path );
+		/// Removes the prim at \p path, its properties and every prim below it.
+		void RemovePrim( const SdfPath& path );
 		[[nodiscard]] std::optional< const Prim* > GetPrim( const SdfPath& path ) const;
 		[[nodiscard]] std::optional< Prim* > GetPrim( const SdfPath& path );
 
@@ -137,8 +167,30 @@ namespace remedy
 
 		[[nodiscard]] SdfPath GetRootPath() const;
 
+		/// Moves the large arrays of every property into the process-wide ArrayStore.
+		void ShareArrays();
+
+		/// Stops a conversion running on another thread at its next checkpoint.
+		void Cancel()
+		{
+			m_cancelToken.Cancel();
+		}
+
+		/// Returns the token polled by the readers to stop a conversion early.
+		[[nodiscard]] const CancelToken& GetCancelToken() const
+		{
+			return m_cancelToken;
+		}
+
+		[[nodiscard]] const Options& GetOptions() const
+		{
+			return m_options;
+		}
+
 	private:
 		std::string m_errorLog;
+		CancelToken m_cancelToken;
+		Options m_options;
 		using PrimMap = std::map< SdfPath, Prim >;
 		PrimMap m_prims;
 		Prim* m_pseudoRoot = nullptr;
@@ -2,10 +2,13 @@
 
 #include "UsdFbxFileformat.h"
 
+#include "CompressedFbxStream.h"
 #include "DebugCodes.h"
 #include "Error.h"
 #include "PrecompiledHeader.h"
+#include "Tokens.h"
 #include "UsdFbxAbstractData.h"
+#include "UsdFbxLayerCache.h"
 
 DIAGNOSTIC_PUSH
 IGNORE_USD_WARNINGS
@@ -20,6 +23,7 @@ IGNORE_USD_WARNINGS
 #include <pxr/usd/sdf/layer.h>
 #include <pxr/usd/usd/stage.h>
 #include <pxr/usd/usd/usdaFileFormat.h>
+#include <pxr/usd/usd/usdcFileFormat.h>
 #include <pxr/usd/usdGeom/mesh.h>
 #include <pxr/usd/usdGeom/metrics.h>
 #include <pxr/usd/usdGeom/xform.h>
@@ -49,6 +53,7 @@ remedy::UsdFbxFileFormat::UsdFbxFileFormat()
 		UsdFbxFileFormatTokens->Target,
 		UsdFbxFileFormatTokens->Id )
 	, m_usda( FindById( UsdUsdaFileFormatTokens->Id ) )
+	, m_usdc( FindById( UsdUsdcFileFormatTokens->Id ) )
 {
 }
 
@@ -85,6 +90,14 @@ bool remedy::UsdFbxFileFormat::CanRead( const std::string& file ) const
 		return false;
 	}
 
+	// "gz" and "zst" are registered by USDFBX_REGISTER_COMPRESSED_EXTENSIONS builds,
+	// but only compressed Fbx files are read
+	const FbxCompression compression = GetFbxCompression( file );
+	if( compression != FbxCompression::None )
+	{
+		return IsFbxCompressionSupported( compression );
+	}
+
 	return extension == GetFormatId();
 }
 
@@ -105,6 +118,17 @@ bool remedy::UsdFbxFileFormat::Read( SdfLayer* layer, const std::string& resolve
 		resolvedPath.c_str(),
 		TfStringify( metadataOnly ).c_str() );
 
+	// A previously converted copy of this file is read as plain usdc data
+	const std::string cachePath = UsdFbxLayerCache::GetDiskCachePath( resolvedPath, layer->GetFileFormatArguments() );
+	if( !cachePath.empty() && TfIsFile( cachePath ) )
+	{
+		TF_DEBUG( USDFBX ).Msg( "UsdFbx - Reading \"%s\" from cache \"%s\"\n", resolvedPath.c_str(), cachePath.c_str() );
+		if( m_usdc->Read( layer, cachePath, metadataOnly ) )
+		{
+			return true;
+		}
+	}
+
 	auto data = InitData( layer->GetFileFormatArguments() );
 	const auto fbxData = TfStatic_cast< UsdFbxAbstractDataRefPtr >( data );
 	if( !fbxData->Open( resolvedPath ) )
@@ -113,6 +137,19 @@ bool remedy::UsdFbxFileFormat::Read( SdfLayer* layer, const std::string& resolve
 	}
 
 	_SetLayerData( layer, data );
+
+	// Partial layers from cancelled opens are never cached. The cache is written in
+	// the background from a layer of its own, which shares the converted data that
+	// nothing modifies, instead of holding up the open with the usdc export
+	const bool isPartial = layer->GetCustomLayerData().count( UsdFbxLayerDataTokens->partial.GetString() ) > 0;
+	if( !cachePath.empty() && !metadataOnly && !isPartial )
+	{
+		const auto& args = layer->GetFileFormatArguments();
+		SdfLayerRefPtr cacheLayer = SdfLayer::CreateAnonymous( "usdFbxCache.fbx", FindById( GetFormatId() ), args );
+		SdfAbstractDataRefPtr cacheData = UsdFbxAbstractData::New( args, fbxData->GetReader() );
+		_SetLayerData( get_pointer( cacheLayer ), cacheData );
+		UsdFbxLayerCache::GetInstance().WriteDiskCacheAsync( std::move( cacheLayer ), cachePath );
+	}
 	return true;
 }
 
@@ -46,5 +46,6 @@ namespace remedy
 
 	private:
 		SdfFileFormatConstPtr m_usda;
+		SdfFileFormatConstPtr m_usdc;
 	};
 } // namespace remedy
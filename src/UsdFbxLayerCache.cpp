@@ -0,0 +1,381 @@
+// Copyright (C) Remedy Entertainment Plc.
+
+#include "UsdFbxLayerCache.h"
+
+#include "DebugCodes.h"
+#include "PrecompiledHeader.h"
+#include "UsdFbxDataReader.h"
+#include "UsdFbxFileformat.h"
+
+#include <pxr/base/arch/fileSystem.h>
+#include <pxr/base/arch/hash.h>
+#include <pxr/base/arch/timing.h>
+#include <pxr/base/tf/envSetting.h>
+#include <pxr/base/tf/errorMark.h>
+#include <pxr/base/tf/fileUtils.h>
+#include <pxr/base/tf/pathUtils.h>
+#include <pxr/base/tf/stringUtils.h>
+#include <pxr/base/trace/trace.h>
+#include <pxr/base/work/threadLimits.h>
+#include <pxr/usd/sdf/layer.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+TF_DEFINE_ENV_SETTING(
+	USDFBX_CACHE_DIR,
+	"",
+	"Directory in which converted Fbx layers are cached as usdc files. Caching is disabled when empty" );
+
+TF_DEFINE_ENV_SETTING(
+	USDFBX_PREWARM_EXPIRY,
+	600,
+	"Seconds after which a prewarmed Fbx file that no layer has opened is dropped from memory" );
+
+namespace
+{
+	using ReaderPtr = std::shared_ptr< remedy::UsdFbxDataReader >;
+
+	std::string makeKey( const std::string& filePath, const SdfFileFormat::FileFormatArguments& args )
+	{
+		std::string key = TfNormPath( TfAbsPath( filePath ) );
+		for( const auto& [ name, value ] : args )
+		{
+			key += ":" + name + "=" + value;
+		}
+		return key;
+	}
+
+	double getModificationTime( const std::string& filePath )
+	{
+		double time = 0.0;
+		ArchGetModificationTime( filePath.c_str(), &time );
+		return time;
+	}
+
+	// Reads the whole file once so that it sits in the OS file cache when the Fbx SDK
+	// opens it. This is the only part of a conversion that does not need the SDK lock,
+	// and therefore the part that benefits from running several files concurrently.
+	void warmFileCache( const std::string& filePath )
+	{
+		TRACE_FUNCTION()
+		std::ifstream stream( filePath, std::ios::binary );
+		std::vector< char > buffer( 1 << 20 );
+		while( stream.read( buffer.data(), static_cast< std::streamsize >( buffer.size() ) ) )
+		{
+		}
+	}
+
+	std::shared_future< void > makeReadyFuture()
+	{
+		std::promise< void > promise;
+		promise.set_value();
+		return promise.get_future().share();
+	}
+} // namespace
+
+remedy::UsdFbxLayerCache& remedy::UsdFbxLayerCache::GetInstance()
+{
+	// Never destroyed, Shutdown() stops the workers that use it at exit
+	static UsdFbxLayerCache* instance = new UsdFbxLayerCache();
+	return *instance;
+}
+
+ReaderPtr remedy::UsdFbxLayerCache::convert( const std::string& filePath, const SdfFileFormat::FileFormatArguments& args )
+{
+	TRACE_FUNCTION()
+	warmFileCache( filePath );
+
+	auto reader = std::make_shared< UsdFbxDataReader >();
+	{
+		std::lock_guard lock( m_mutex );
+		if( m_shutdown )
+		{
+			return nullptr;
+		}
+		m_converting.insert( reader.get() );
+	}
+
+	// Errors are not reported from the background, a file that fails to convert
+	// here is opened (and reports its errors) on demand instead.
+	TfErrorMark mark;
+	const bool success = reader->Open( filePath, args );
+	mark.Clear();
+
+	std::lock_guard lock( m_mutex );
+	m_converting.erase( reader.get() );
+	if( !success || reader->GetCancelToken().WasCancelled() )
+	{
+		TF_DEBUG( USDFBX ).Msg( "UsdFbx - Prewarming \"%s\" failed, it will be opened on demand\n", filePath.c_str() );
+		return nullptr;
+	}
+	return reader;
+}
+
+void remedy::UsdFbxLayerCache::evictExpired()
+{
+	const auto now = Clock::now();
+	for( auto it = m_entries.begin(); it != m_entries.end(); )
+	{
+		if( it->second.expiry && *it->second.expiry <= now )
+		{
+			TF_DEBUG( USDFBX ).Msg( "UsdFbx - Dropping \"%s\" from the layer cache, it was never opened\n", it->first.c_str() );
+			it = m_entries.erase( it );
+		}
+		else
+		{
+			++it;
+		}
+	}
+}
+
+std::shared_future< void > remedy::UsdFbxLayerCache::Prewarm(
+	const std::vector< std::string >& filePaths,
+	const SdfFileFormat::FileFormatArguments& args,
+	size_t maxThreads )
+{
+	if( m_shutdown )
+	{
+		return makeReadyFuture();
+	}
+
+	struct Job
+	{
+		std::string filePath;
+		std::string key;
+		std::promise< ReaderPtr > promise;
+	};
+	auto jobs = std::make_shared< std::vector< Job > >();
+
+	{
+		std::lock_guard lock( m_mutex );
+		evictExpired();
+		for( const auto& filePath : filePaths )
+		{
+			std::string key = makeKey( filePath, args );
+			if( m_entries.find( key ) != m_entries.end() )
+			{
+				continue;
+			}
+
+			Job job{ filePath, key, std::promise< ReaderPtr >() };
+			m_entries[ key ] = { job.promise.get_future().share(), getModificationTime( filePath ), std::nullopt };
+			jobs->push_back( std::move( job ) );
+		}
+	}
+
+	const size_t threadLimit = maxThreads > 0 ? maxThreads : static_cast< size_t >( WorkGetConcurrencyLimit() );
+	const size_t numThreads = std::min( jobs->size(), threadLimit );
+	TF_DEBUG( USDFBX ).Msg( "UsdFbx - Prewarming %zu Fbx files on %zu threads\n", jobs->size(), numThreads );
+
+	auto convertAll = [ this, jobs, args, numThreads ]()
+	{
+		const auto expiry = std::chrono::seconds( TfGetEnvSetting( USDFBX_PREWARM_EXPIRY ) );
+		std::atomic< size_t > next = 0;
+		std::vector< std::thread > workers;
+		for( size_t i = 0; i < numThreads; ++i )
+		{
+			workers.emplace_back(
+				[ & ]()
+				{
+					for( size_t job = next++; job < jobs->size(); job = next++ )
+					{
+						auto& [ filePath, key, promise ] = ( *jobs )[ job ];
+						promise.set_value( convert( filePath, args ) );
+
+						std::lock_guard lock( m_mutex );
+						const auto it = m_entries.find( key );
+						if( it != m_entries.end() )
+						{
+							it->second.expiry = Clock::now() + expiry;
+						}
+					}
+				} );
+		}
+		for( auto& worker : workers )
+		{
+			worker.join();
+		}
+	};
+	std::shared_future< void > batch = std::async( std::launch::async, std::move( convertAll ) ).share();
+	addBatch( batch );
+	return batch;
+}
+
+void remedy::UsdFbxLayerCache::addBatch( const std::shared_future< void >& batch )
+{
+	// Registered on first use, after the Fbx SDK and USD, so that it runs before they are torn down
+	std::call_once( m_atExitFlag, []() { std::atexit( []() { GetInstance().Shutdown(); } ); } );
+
+	// Keep a reference around so that dropping the returned future never blocks the caller
+	std::lock_guard lock( m_mutex );
+	m_batches.erase(
+		std::remove_if(
+			m_batches.begin(),
+			m_batches.end(),
+			[]( const auto& f ) { return f.wait_for( std::chrono::seconds( 0 ) ) == std::future_status::ready; } ),
+		m_batches.end() );
+	m_batches.push_back( batch );
+}
+
+std::shared_ptr< remedy::UsdFbxDataReader > remedy::UsdFbxLayerCache::Take(
+	const std::string& filePath,
+	const SdfFileFormat::FileFormatArguments& args )
+{
+	Entry entry;
+	{
+		std::lock_guard lock( m_mutex );
+		evictExpired();
+		const auto it = m_entries.find( makeKey( filePath, args ) );
+		if( it == m_entries.end() )
+		{
+			return nullptr;
+		}
+		entry = std::move( it->second );
+		m_entries.erase( it );
+	}
+
+	TRACE_FUNCTION()
+	ReaderPtr reader = entry.reader.get();
+	if( reader && getModificationTime( filePath ) != entry.modificationTime )
+	{
+		TF_DEBUG( USDFBX ).Msg( "UsdFbx - \"%s\" changed since it was prewarmed, discarding\n", filePath.c_str() );
+		return nullptr;
+	}
+
+	TF_DEBUG( USDFBX ).Msg( "UsdFbx - Serving \"%s\" from the layer cache\n", filePath.c_str() );
+	return reader;
+}
+
+std::vector< std::shared_future< void > > remedy::UsdFbxLayerCache::GetPendingBatches()
+{
+	std::lock_guard lock( m_mutex );
+	std::vector< std::shared_future< void > > pending;
+	for( const auto& batch : m_batches )
+	{
+		if( batch.wait_for( std::chrono::seconds( 0 ) ) != std::future_status::ready )
+		{
+			pending.push_back( batch );
+		}
+	}
+	return pending;
+}
+
+size_t remedy::UsdFbxLayerCache::GetSize()
+{
+	std::lock_guard lock( m_mutex );
+	evictExpired();
+	return m_entries.size();
+}
+
+void remedy::UsdFbxLayerCache::Clear()
+{
+	// Destroyed outside of the lock, readers can take a while to release
+	std::map< std::string, Entry > entries;
+	std::lock_guard lock( m_mutex );
+	entries.swap( m_entries );
+}
+
+void remedy::UsdFbxLayerCache::Shutdown()
+{
+	std::vector< std::shared_future< void > > batches;
+	{
+		std::lock_guard lock( m_mutex );
+		m_shutdown = true;
+		for( UsdFbxDataReader* reader : m_converting )
+		{
+			reader->Cancel();
+		}
+		batches = m_batches;
+	}
+
+	TF_DEBUG( USDFBX ).Msg( "UsdFbx - Waiting for %zu prewarm batches to stop\n", batches.size() );
+	for( const auto& batch : batches )
+	{
+		batch.wait();
+	}
+	Clear();
+}
+
+std::string remedy::UsdFbxLayerCache::GetDiskCachePath( const std::string& filePath, const SdfFileFormat::FileFormatArguments& args )
+{
+	const std::string& cacheDir = TfGetEnvSetting( USDFBX_CACHE_DIR );
+	if( cacheDir.empty() )
+	{
+		return {};
+	}
+
+	double modificationTime = 0.0;
+	if( !ArchGetModificationTime( filePath.c_str(), &modificationTime ) )
+	{
+		return {};
+	}
+
+	const std::string key = TfStringPrintf(
+		"%s|%f|%lld|%s",
+		makeKey( filePath, args ).c_str(),
+		modificationTime,
+		static_cast< long long >( ArchGetFileLength( filePath.c_str() ) ),
+		UsdFbxFileFormatTokens->Version.GetText() );
+	return TfStringCatPaths(
+		cacheDir,
+		TfStringPrintf( "%016llx.usdc", static_cast< unsigned long long >( ArchHash64( key.data(), key.size() ) ) ) );
+}
+
+bool remedy::UsdFbxLayerCache::WriteDiskCache( const SdfLayerRefPtr& layer, const std::string& cachePath )
+{
+	TRACE_FUNCTION()
+	const std::string cacheDir = TfGetPathName( cachePath );
+	if( !TfIsDir( cacheDir ) && !TfMakeDirs( cacheDir, -1, true ) )
+	{
+		TF_WARN( "Unable to create the usdFbx cache directory \"%s\"", cacheDir.c_str() );
+		return false;
+	}
+
+	// Export under a unique name first so that other processes never see a partially written file.
+	// The usdc extension picks the file format, whatever the format of the layer
+	const std::string tmpPath = TfStringPrintf(
+		"%s.%zx%llx.usdc",
+		TfStringGetBeforeSuffix( cachePath ).c_str(),
+		std::hash< std::thread::id >()( std::this_thread::get_id() ),
+		static_cast< unsigned long long >( ArchGetTickTime() ) );
+	if( !layer->Export( tmpPath ) )
+	{
+		return false;
+	}
+
+	std::error_code error;
+	std::filesystem::rename( tmpPath, cachePath, error );
+	if( error )
+	{
+		TfDeleteFile( tmpPath );
+		return false;
+	}
+
+	TF_DEBUG( USDFBX ).Msg( "UsdFbx - Cached \"%s\" to \"%s\"\n", layer->GetIdentifier().c_str(), cachePath.c_str() );
+	return true;
+}
+
+void remedy::UsdFbxLayerCache::WriteDiskCacheAsync( SdfLayerRefPtr layer, const std::string& cachePath )
+{
+	if( m_shutdown )
+	{
+		return;
+	}
+	auto write = [ layer = std::move( layer ), cachePath ]() { WriteDiskCache( layer, cachePath ); };
+	addBatch( std::async( std::launch::async, std::move( write ) ).share() );
+}
+
+std::shared_future< void > remedy::PrewarmAssets(
+	const std::vector< std::string >& filePaths,
+	const SdfFileFormat::FileFormatArguments& args,
+	size_t maxThreads )
+{
+	return UsdFbxLayerCache::GetInstance().Prewarm( filePaths, args, maxThreads );
+}
@@ -0,0 +1,133 @@
+// Copyright (C) Remedy Entertainment Plc.
+
+#pragma once
+
+#include "Api.h"
+
+#include <pxr/pxr.h>
+#include <pxr/usd/sdf/fileFormat.h>
+#include <pxr/usd/sdf/layer.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+namespace remedy
+{
+	class UsdFbxDataReader;
+
+	/// \class UsdFbxLayerCache
+	///
+	/// Holds Fbx files converted ahead of time so that UsdFbxFileFormat::Read can
+	/// serve them without touching the Fbx SDK.
+	///
+	/// The in-process cache is filled by Prewarm() and drained by Take(): a
+	/// converted file is handed to the first layer that asks for it and is not
+	/// retained afterwards. Converted files that no layer takes are dropped once
+	/// USDFBX_PREWARM_EXPIRY seconds have passed. When USDFBX_CACHE_DIR is set,
+	/// converted layers are additionally written to (and read back from) that
+	/// directory as usdc files.
+	///
+	/// The cache is never destroyed. The conversions still running when the
+	/// process exits are cancelled and waited upon by an atexit handler, before the
+	/// Fbx SDK and USD are torn down.
+	class UsdFbxLayerCache
+	{
+	public:
+		static UsdFbxLayerCache& GetInstance();
+
+		/// Converts \p filePaths in the background using at most \p maxThreads
+		/// workers (0 uses the hardware concurrency). The returned future completes
+		/// once every file has been converted or has failed to convert.
+		///
+		/// The Fbx SDK is not thread safe, the imports themselves run one at a
+		/// time under its lock. The workers only overlap what happens outside of
+		/// it: reading the files from disk, parsing ASCII geometry and sharing
+		/// arrays.
+		std::shared_future< void > Prewarm(
+			const std::vector< std::string >& filePaths,
+			const SdfFileFormat::FileFormatArguments& args,
+			size_t maxThreads );
+
+		/// Removes and returns the converted reader for \p filePath, waiting for it
+		/// if the conversion is still running. Returns nullptr when the file was not
+		/// prewarmed, failed to convert, expired or changed on disk since.
+		std::shared_ptr< UsdFbxDataReader > Take( const std::string& filePath, const SdfFileFormat::FileFormatArguments& args );
+
+		/// Returns the futures of the conversions that have not completed yet.
+		std::vector< std::shared_future< void > > GetPendingBatches();
+
+		/// Returns the number of files converted or being converted that no layer
+		/// has taken yet, after dropping the expired ones.
+		size_t GetSize();
+
+		/// Drops every converted file that no layer has taken yet.
+		void Clear();
+
+		/// Cancels the conversions that are still running, waits for them and drops
+		/// the converted files. Prewarm() does nothing afterwards.
+		void Shutdown();
+
+		/// Returns the usdc file used to cache \p filePath, or an empty string when
+		/// USDFBX_CACHE_DIR is not set. The name encodes the file's modification time
+		/// and size, so stale entries are never picked up.
+		static std::string GetDiskCachePath( const std::string& filePath, const SdfFileFormat::FileFormatArguments& args );
+
+		/// Writes the content of \p layer to \p cachePath.
+		static bool WriteDiskCache( const SdfLayerRefPtr& layer, const std::string& cachePath );
+
+		/// Writes \p layer to \p cachePath on a background thread, so that the open
+		/// that converted it does not wait for the export. Shutdown() waits for the
+		/// writes still running at exit.
+		void WriteDiskCacheAsync( SdfLayerRefPtr layer, const std::string& cachePath );
+
+		UsdFbxLayerCache( const UsdFbxLayerCache& ) = delete;
+		void operator=( const UsdFbxLayerCache& ) = delete;
+
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		UsdFbxLayerCache() = default;
+
+		std::shared_ptr< UsdFbxDataReader >
+		convert( const std::string& filePath, const SdfFileFormat::FileFormatArguments& args );
+
+		// Called with m_mutex held
+		void evictExpired();
+
+		// Keeps batch until it completes, for GetPendingBatches() and Shutdown()
+		void addBatch( const std::shared_future< void >& batch );
+
+		struct Entry
+		{
+			std::shared_future< std::shared_ptr< UsdFbxDataReader > > reader;
+			double modificationTime = 0.0;
+			// Set once the conversion is done, entries still converting never expire
+			std::optional< Clock::time_point > expiry;
+		};
+
+		std::mutex m_mutex;
+		std::map< std::string, Entry > m_entries;
+		std::vector< std::shared_future< void > > m_batches;
+		// Readers being converted, cancelled by Shutdown()
+		std::set< UsdFbxDataReader* > m_converting;
+		std::atomic< bool > m_shutdown = false;
+		std::once_flag m_atExitFlag;
+	};
+
+	/// Converts \p filePaths into the in-process layer cache on background threads.
+	/// Layers opened for these files afterwards are served from the cache.
+	USDFBX_API std::shared_future< void > PrewarmAssets(
+		const std::vector< std::string >& filePaths,
+		const SdfFileFormat::FileFormatArguments& args = {},
+		size_t maxThreads = 0 );
+} // namespace remedy
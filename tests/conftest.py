@@ -1,4 +1,6 @@
+import math
 import pathlib
+import sys
 import uuid
 from dotenv import load_dotenv
 import pytest
@@ -12,9 +14,11 @@ load_dotenv(
 import FbxCommon as fbx
 from pxr import Usd, Plug, Gf, UsdGeom
 
-from data import TransformableNode, scenebuilder, MappedCoordinates, Mesh
+from data import TransformableNode, scenebuilder, MappedCoordinates, Mesh, OpticalMarker, Transform
 
-from helpers import create_FbxTime
+from helpers import create_FbxTime, PYTHON_MODULE_DIR
+
+sys.path.insert(0, str(PYTHON_MODULE_DIR))
 
 
 @pytest.fixture
@@ -169,6 +173,114 @@ def basic_plane_fbx(fbx_defaults):
     yield str(builder.settings.file_path), builder.settings, builder.nodes
 
 
+@pytest.fixture
+def degenerate_plane_fbx(fbx_defaults):
+    output_dir, manager, scene, fbx_file_format = fbx_defaults
+    with scenebuilder.SceneBuilder(manager, scene, output_dir) as builder:
+        builder.settings.file_format = fbx_file_format
+        texcoords = MappedCoordinates(
+            name="set_a",
+            coordinates=[(0, 0), (1, 0), (1, 1), (0, 1)],
+            point_mapping=[0, 3, 2, 2, 1, 0, 0, 1, 1, 0, 1, 1],
+        )
+        mesh = Mesh(
+            name="degenerate_plane",
+            # Point 4 is not referenced, point 5 lies between points 0 and 1
+            points=[(-1, 0, -1), (1, 0, -1), (1, 0, 1), (-1, 0, 1), (5, 5, 5), (0, 0, -1)],
+            normals=MappedCoordinates(coordinates=[(0, 1, 0)], point_mapping=[0] * 12),
+            # A repeated point and a face without area follow the two triangles of the plane
+            polygons=[(0, 3, 2), (2, 1, 0), (0, 1, 1), (0, 5, 1)],
+            uvs=[texcoords],
+        )
+        builder.nodes.append(mesh)
+
+    yield str(builder.settings.file_path), builder.settings, builder.nodes
+
+
+@pytest.fixture
+def optical_markers_fbx(fbx_defaults):
+    output_dir, manager, scene, fbx_file_format = fbx_defaults
+    with scenebuilder.SceneBuilder(manager, scene, output_dir) as builder:
+        builder.settings.file_format = fbx_file_format
+        parent = TransformableNode("markers", transform=Transform(t=(0.0, 10.0, 0.0)))
+        builder.nodes.append(parent)
+        for i in range(3):
+            marker = OpticalMarker(f"marker{i}", parent=parent, transform=Transform(t=(float(i), 0.0, 0.0)))
+            builder.nodes.append(marker)
+        # Nothing is converted under the markers
+        builder.nodes.append(TransformableNode("marker_child", parent=builder.nodes[1]))
+        # Only turns into "opticalMarkers" once its leading space is trimmed
+        builder.nodes.append(TransformableNode(" opticalMarkers", parent=parent))
+
+    yield str(builder.settings.file_path), builder.settings, builder.nodes
+
+
+def create_grid_mesh(name, side, triangulated=False, **kwargs):
+    """
+    A bumpy grid of side x side quads, its coordinates use every digit of their ASCII representation.
+    Triangulated grids split every quad in two, row after row
+    """
+    points = [
+        (x + 0.123456789 * math.sin(z), 0.987654321 * math.cos(x * z), z - 0.5 * math.sin(x))
+        for z in range(side + 1)
+        for x in range(side + 1)
+    ]
+    polygons = [
+        (z * (side + 1) + x, (z + 1) * (side + 1) + x, (z + 1) * (side + 1) + x + 1, z * (side + 1) + x + 1)
+        for z in range(side)
+        for x in range(side)
+    ]
+    if triangulated:
+        polygons = [triangle for a, b, c, d in polygons for triangle in ((a, b, c), (a, c, d))]
+    return Mesh(name=name, points=points, polygons=polygons, **kwargs)
+
+
+@pytest.fixture(scope="session")
+def triangle_grid_fbx(fbx_defaults):
+    # Drawn row after row, every row is longer than a 32 entry vertex cache, with face varying uvs on top
+    output_dir, manager, scene, fbx_file_format = fbx_defaults
+    side = 64
+    with scenebuilder.SceneBuilder(manager, scene, output_dir) as builder:
+        builder.settings.file_format = fbx_file_format
+        grid = create_grid_mesh("triangle_grid", side, triangulated=True)
+        grid.uvs = [
+            MappedCoordinates(
+                name="set_a",
+                coordinates=[(x / side, z / side) for z in range(side + 1) for x in range(side + 1)],
+                point_mapping=[index for polygon in grid.polygons for index in polygon],
+            )
+        ]
+        builder.nodes.append(grid)
+
+    yield str(builder.settings.file_path), builder.settings, builder.nodes
+
+
+@pytest.fixture(scope="session")
+def large_grid_fbx(fbx_defaults):
+    # Its arrays are well above the size at which the ASCII fast path parses them in parallel, and above the
+    # size at which layers share them
+    output_dir, manager, scene, fbx_file_format = fbx_defaults
+    with scenebuilder.SceneBuilder(manager, scene, output_dir) as builder:
+        builder.settings.file_format = fbx_file_format
+        builder.nodes.append(create_grid_mesh("large_grid", 128))
+
+    yield str(builder.settings.file_path), builder.settings, builder.nodes
+
+
+@pytest.fixture(scope="session")
+def smoothed_grid_fbx(fbx_defaults):
+    output_dir, manager, scene, fbx_file_format = fbx_defaults
+    side = 64
+    edge_count = 2 * side * (side + 1)
+    with scenebuilder.SceneBuilder(manager, scene, output_dir) as builder:
+        builder.settings.file_format = fbx_file_format
+        # Every third edge is hard
+        smoothing = tuple(int(i % 3 != 0) for i in range(edge_count))
+        builder.nodes.append(create_grid_mesh("smoothed_grid", side, edge_smoothing=smoothing))
+
+    yield str(builder.settings.file_path), builder.settings, builder.nodes
+
+
 @pytest.fixture(scope="session")
 def simple_hierarchy_fbx(fbx_defaults):
     output_dir, manager, scene, fbx_file_format = fbx_defaults
@@ -106,6 +106,7 @@ class Property:
     data_name_and_type: Tuple[
         str, fbx.EFbxType
     ] = None  # only used in conjunction with user_defined
+    enum_values: Tuple[str, ...] = ()  # names of the values of an eFbxEnum user property
     animation_curves: List[AnimationCurve] = field(default_factory=list)
 
 
@@ -177,6 +178,8 @@ class Mesh(TransformableNode):
         fbx.FbxLayerElement.EReferenceMode.eIndexToDirect
     )
     skinbinding: Tuple[SkinBinding, ...] = ()
+    # Smoothing of every edge, in the order FbxMesh.BuildMeshEdgeArray lays them out. Authored by edge when not empty
+    edge_smoothing: Tuple[int, ...] = ()
 
     # Necessary so we can use Mesh instances as keys in dicts
     def __hash__(self):
@@ -191,6 +194,7 @@ class Mesh(TransformableNode):
             + hash(tuple(self.uvs))
             + hash(tuple(self.vertex_colors))
             + hash(self.skinbinding)
+            + hash(self.edge_smoothing)
         )
 
 
@@ -220,6 +224,12 @@ class Camera(TransformableNode):
         return super().__hash__() + hashed
 
 
+@dataclass
+class OpticalMarker(TransformableNode):
+    def __hash__(self):
+        return super().__hash__()
+
+
 @dataclass
 class NodeValidationData:
     name: str
@@ -6,6 +6,7 @@ from . import (
     Joint,
     Camera,
     Mesh,
+    OpticalMarker,
     TransformableNode,
     Transform,
     Property,
@@ -58,6 +59,8 @@ def set_or_create_properties(node, properties: List[Property], scene: fbx.FbxSce
             fbx_prop = fbx.FbxProperty.Create(
                 node, data_type, property.name, property.name
             )
+        for enum_value in property.enum_values:
+            fbx_prop.AddEnumValue(enum_value)
         fbx_prop.Set(property.value)
         if property.user_defined:
             fbx_prop.ModifyFlag(fbx.FbxPropertyFlags.EFlags.eUserDefined, True)
@@ -114,6 +117,20 @@ def create_mesh(manager: fbx.FbxManager, mesh: Mesh):
             fbx_mesh.AddPolygon(vertex)
         fbx_mesh.EndPolygon()
 
+    # Smoothing, by edge
+    if mesh.edge_smoothing:
+        fbx_mesh.BuildMeshEdgeArray()
+        if fbx_mesh.GetMeshEdgeCount() != len(mesh.edge_smoothing):
+            raise ValueError(
+                f"Mesh `{mesh.name}` has {fbx_mesh.GetMeshEdgeCount()} edges, "
+                f"got {len(mesh.edge_smoothing)} smoothing values"
+            )
+        smoothing_element = fbx_mesh.CreateElementSmoothing()
+        smoothing_element.SetMappingMode(fbx.FbxLayerElement.EMappingMode.eByEdge)
+        smoothing_element.SetReferenceMode(fbx.FbxLayerElement.EReferenceMode.eDirect)
+        for value in mesh.edge_smoothing:
+            smoothing_element.GetDirectArray().Add(value)
+
     # Normals
     if mesh.normals is not None:
         validate_coordinate_mapping(
@@ -191,6 +208,14 @@ def create_null(manager: fbx.FbxManager, null: TransformableNode):
     return fbx_node, fbx_null
 
 
+def create_optical_marker(manager: fbx.FbxManager, marker: OpticalMarker):
+    fbx_node = fbx.FbxNode.Create(manager, marker.name)
+    fbx_marker = fbx.FbxMarker.Create(manager, "")
+    fbx_marker.SetType(fbx.FbxMarker.EType.eOptical)
+    fbx_node.SetNodeAttribute(fbx_marker)
+    return fbx_node, fbx_marker
+
+
 def create_joint(manager: fbx.FbxManager, joint: Joint):
     fbx_node = fbx.FbxNode.Create(manager, joint.name)
     fbx_joint = fbx.FbxSkeleton.Create(manager, joint.name)
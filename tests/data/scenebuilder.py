@@ -12,6 +12,7 @@ from . import (
     Camera,
     Mesh,
     Joint,
+    OpticalMarker,
 )
 
 class Builder:
@@ -31,6 +32,7 @@ class Builder:
             Mesh: primitives.create_mesh,
             TransformableNode: primitives.create_null,
             Camera: primitives.create_camera,
+            OpticalMarker: primitives.create_optical_marker,
         }
 
         settings = self.scene.GetGlobalSettings()
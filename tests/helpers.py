@@ -1,7 +1,14 @@
+import os
+import pathlib
+import subprocess
+import sys
 import uuid
 from pxr import Usd
 import FbxCommon as fbx
 
+# The usdFbx Python module is imported from the source tree
+PYTHON_MODULE_DIR = pathlib.Path(__file__).resolve().parent.parent / "python"
+
 
 def validate_property_animation(stage, prop, expected_start_end_values):
     start_time, end_time = stage.GetStartTimeCode(), stage.GetEndTimeCode()
@@ -38,3 +45,13 @@ def create_FbxTime(frames):
     time = fbx.FbxTime()
     time.SetFrame(frames)
     return time
+
+
+def run_python(script, *args, **environment):
+    """
+    Runs a script in a fresh interpreter that can import usdFbx and returns its exit code.
+    Used for the plugin state that only exists once per process.
+    """
+    env = dict(os.environ, **environment)
+    env["PYTHONPATH"] = os.pathsep.join(filter(None, [str(PYTHON_MODULE_DIR), env.get("PYTHONPATH")]))
+    return subprocess.run([sys.executable, "-c", script, *args], env=env).returncode
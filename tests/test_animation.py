@@ -1,10 +1,10 @@
 from cmath import exp
 import pytest
 
-from pxr import Usd, Gf
+from pxr import Sdf, Usd, Gf, Tf
 import FbxCommon as fbx
 
-from helpers import validate_property_animation, validate_stage_time_metrics
+from helpers import create_FbxTime, validate_property_animation, validate_stage_time_metrics
 from data import scenebuilder, AnimationCurve, Property, TransformableNode
 
 
@@ -147,3 +147,133 @@ def test_user_property_animation(animated_user_property_fbx, root_prim_name):
     if start_end_flipped:
         expected_values = reversed(expected_values)
     validate_property_animation(stage, prop, expected_values)
+
+
+@pytest.fixture(scope="session")
+def indexed_properties_fbx(fbx_defaults, fbx_animation_time_codes):
+    output_dir, manager, scene, fbx_file_format = fbx_defaults
+    fbx_times, _ = fbx_animation_time_codes
+    with scenebuilder.SceneBuilder(manager, scene, output_dir) as builder:
+        builder.settings.file_format = fbx_file_format
+        builder.settings.anim_layers = ("Base",)
+
+        def user_property(name, values):
+            curves = [AnimationCurve(anim_layer="Base", times=fbx_times, values=values)] if len(values) > 1 else []
+            return Property(
+                name=name,
+                animation_curves=curves,
+                value=values[0],
+                user_defined=True,
+                data_name_and_type=("Number", fbx.EFbxType.eFbxFloat),
+            )
+
+        translation = Property(
+            name="LclTranslation",
+            animation_curves=[
+                AnimationCurve(
+                    anim_layer="Base",
+                    times=fbx_times,
+                    values=[fbx.FbxDouble3(0.0, 0.0, 0.0), fbx.FbxDouble3(10.0, 0.0, 0.0)],
+                )
+            ],
+            value=fbx.FbxDouble3(0.0, 0.0, 0.0),
+        )
+        builder.nodes.append(TransformableNode("static_user", properties=[user_property("someStatic", [1.0])]))
+        animated = user_property("someAnimated", [-1.0, 1.0])
+        builder.nodes.append(TransformableNode("animated_user", properties=[animated]))
+        builder.nodes.append(TransformableNode("animated_transform", properties=[translation]))
+        builder.nodes.append(TransformableNode("plain"))
+    yield str(builder.settings.file_path)
+
+
+def test_property_index(indexed_properties_fbx, root_prim_name, registry, capfd):
+    # Animated properties come from the curve nodes indexed up front, user defined
+    # properties are looked up once per node, when that node is read
+    registry.GetPluginWithName("usdFbx").Load()
+    capfd.readouterr()
+    Tf.Debug.SetDebugSymbolsByName("USDFBX", 1)
+    Tf.Debug.SetDebugSymbolsByName("USDFBX_FBX_READERS", 1)
+    try:
+        # Anonymous layers are never shared with the layer registry, every open reads the file again
+        layer = Sdf.Layer.OpenAsAnonymous(Sdf.Layer.CreateIdentifier(indexed_properties_fbx, {}))
+    finally:
+        Tf.Debug.SetDebugSymbolsByName("USDFBX", 0)
+        Tf.Debug.SetDebugSymbolsByName("USDFBX_FBX_READERS", 0)
+    out, _ = capfd.readouterr()
+    assert "animation curve nodes over" in out
+    for node, count in (("static_user", 1), ("animated_user", 1), ("animated_transform", 0), ("plain", 0)):
+        assert out.count(f'Found {count} user defined properties on "{node}"') == 1
+
+    def attribute(node, name):
+        return layer.GetAttributeAtPath(f"/{root_prim_name}/{node}.{name}")
+
+    static = attribute("static_user", "userProperties:someStatic")
+    assert static and static.default == 1.0
+    assert not layer.ListTimeSamplesForPath(static.path)
+    assert len(layer.ListTimeSamplesForPath(attribute("animated_user", "userProperties:someAnimated").path)) > 1
+    assert len(layer.ListTimeSamplesForPath(attribute("animated_transform", "xformOp:translate").path)) > 1
+    plain = layer.GetPrimAtPath(f"/{root_prim_name}/plain")
+    assert plain and not [name for name in plain.properties.keys() if name.startswith("userProperties:")]
+
+
+@pytest.fixture
+def fast_moving_fbx(fbx_defaults):
+    output_dir, manager, scene, fbx_file_format = fbx_defaults
+    with scenebuilder.SceneBuilder(manager, scene, output_dir) as builder:
+        builder.settings.file_format = fbx_file_format
+        builder.settings.anim_layers = ("Base",)
+
+        # Keyed on every frame, so that the interpolation cannot change how far it moves over a frame:
+        # 5, 35 and 5 units, only the second frame is above the default linear threshold of 10
+        times = [create_FbxTime(frame) for frame in range(4)]
+        translation = Property(
+            name="LclTranslation",
+            animation_curves=[
+                AnimationCurve(
+                    anim_layer="Base",
+                    times=times,
+                    values=[fbx.FbxDouble3(x, 0.0, 0.0) for x in (0.0, 5.0, 40.0, 45.0)],
+                )
+            ],
+            value=fbx.FbxDouble3(0.0, 0.0, 0.0),
+        )
+        # A degree per frame, well below the default angular threshold of 15
+        rotation = Property(
+            name="LclRotation",
+            animation_curves=[
+                AnimationCurve(
+                    anim_layer="Base",
+                    times=times,
+                    values=[fbx.FbxDouble3(0.0, float(frame), 0.0) for frame in range(4)],
+                )
+            ],
+            value=fbx.FbxDouble3(0.0, 0.0, 0.0),
+        )
+        builder.nodes.append(TransformableNode("null1", properties=[translation, rotation]))
+    yield str(builder.settings.file_path), builder.nodes
+
+
+def test_adaptive_subframe_sampling(fast_moving_fbx, root_prim_name):
+    file_path, nodes = fast_moving_fbx
+    attribute_path = Sdf.Path(f"/{root_prim_name}/{nodes[0].name}.xformOp:translate")
+    rotate_path = attribute_path.GetParentPath().AppendProperty("xformOp:rotateXYZ")
+
+    def sample_times(args, path=attribute_path):
+        return Sdf.Layer.FindOrOpen(file_path, args).ListTimeSamplesForPath(path)
+
+    per_frame = [0.0, 1.0, 2.0, 3.0]
+    assert sample_times({}) == per_frame
+    # Zero is the default, it is accepted and disables subframes
+    assert sample_times({"maxSubframes": "0"}) == per_frame
+
+    # The 35 units of the second frame need ceil(35 / 10) = 4 intervals, which 3 subframes allow
+    adaptive = [0.0, 1.0, 1.25, 1.5, 1.75, 2.0, 3.0]
+    # Subframe times are whole Fbx ticks, a frame does not always divide into them exactly
+    assert sample_times({"maxSubframes": "3"}) == pytest.approx(adaptive)
+    # All the xform ops are sampled at the same times
+    assert sample_times({"maxSubframes": "3"}, rotate_path) == pytest.approx(adaptive)
+    # At most maxSubframes subframes between two frames
+    assert sample_times({"maxSubframes": "2"}) == pytest.approx([0.0, 1.0, 1.0 + 1 / 3, 1.0 + 2 / 3, 2.0, 3.0])
+
+    # Nothing is added when no frame moves further than the thresholds
+    assert sample_times({"maxSubframes": "3", "subframeLinearThreshold": "50"}) == per_frame
@@ -3,10 +3,19 @@ import pytest
 
 import FbxCommon as fbx
 
-from pxr import Usd, Gf
+from pxr import Usd, Gf, Sdf, Vt
 from data import scenebuilder, TransformableNode, Property
 from helpers import create_FbxTime
 
+# Tokens are never freed, strings and blobs can be arbitrarily large and must be stored by value
+LONG_STRING = '{"key": "' + "x" * 1024 + '"}'
+BLOB_BYTES = b"d\x00S\x00"
+
+
+def fbx_blob(data):
+    # Not every release of the Fbx Python SDK exposes FbxBlob
+    return fbx.FbxBlob(data, len(data)) if hasattr(fbx, "FbxBlob") else None
+
 
 @pytest.fixture(
     params=[
@@ -59,8 +68,7 @@ from helpers import create_FbxTime
             ),
             Gf.Matrix4d(*[float(x + 1) for x in range(16)]),
         ),
-        # Unable to set via python SDK
-        # (fbx.eFbxEnum, None, "someEnum"),
+        ((fbx.EFbxType.eFbxEnum, 1, "someEnum", ("first", "second")), "second"),
         (
             (fbx.EFbxType.eFbxString, fbx.FbxString("hello world"), "someString"),
             "hello world",
@@ -69,11 +77,14 @@ from helpers import create_FbxTime
             (fbx.EFbxType.eFbxString, fbx.FbxString("hElLo wOrLd"), "someString"),
             "hElLo wOrLd",
         ),
+        ((fbx.EFbxType.eFbxString, fbx.FbxString(LONG_STRING), "someJson"), LONG_STRING),
         ((fbx.EFbxType.eFbxTime, create_FbxTime(10), "someTime"), Usd.TimeCode(10.0)),
         # Unable to set via python SDK
         # (fbx.eFbxReference, None, "someReference"),
-        # NOTE: While handy, it's probably fine to ignore FbxBlob attributes.
-        # (fbx.eFbxBlob, str("d\x00S\x00"), "someBlob"),
+        pytest.param(
+            ((fbx.EFbxType.eFbxBlob, fbx_blob(BLOB_BYTES), "someBlob"), Vt.UCharArray(list(BLOB_BYTES))),
+            marks=pytest.mark.skipif(not hasattr(fbx, "FbxBlob"), reason="FbxBlob is not exposed to Python"),
+        ),
         # Unable to set via python SDK
         # (fbx.eFbxDistance, fbx.FbxDistance(100.0, fbx.FbxSystemUnit.cm), "someDistance"),
         # Unable to set via python SDK
@@ -83,7 +94,8 @@ from helpers import create_FbxTime
 )
 def user_property_fbx(fbx_defaults, request):
     output_dir, manager, scene, fbx_file_format = fbx_defaults
-    (prop_type, default_value, name), usd_expected = request.param
+    (prop_type, default_value, name, *enum_values), usd_expected = request.param
+    enum_values = enum_values[0] if enum_values else ()
     with scenebuilder.SceneBuilder(manager, scene, output_dir) as builder:
         builder.settings.file_format = fbx_file_format
         prop = Property(
@@ -91,6 +103,7 @@ def user_property_fbx(fbx_defaults, request):
             value=default_value,
             data_name_and_type=("", prop_type),
             user_defined=True,
+            enum_values=enum_values,
         )
         builder.nodes.append(TransformableNode("null1", properties=[prop]))
     yield str(builder.settings.file_path), builder.nodes, name, usd_expected
@@ -115,6 +128,16 @@ def test_user_properties(user_property_fbx, root_prim_name):
     # NOTE: There's something funky with LONG values
     assert expected_value == prop.Get()
 
+    # Only the names of enum values are short enough to be tokens
+    expected_type = {
+        "someString": Sdf.ValueTypeNames.String,
+        "someJson": Sdf.ValueTypeNames.String,
+        "someBlob": Sdf.ValueTypeNames.UCharArray,
+        "someEnum": Sdf.ValueTypeNames.Token,
+    }.get(prop_name)
+    if expected_type is not None:
+        assert prop.GetTypeName() == expected_type
+
 
 def test_bugfix_GetDisplayGroup(user_property_fbx, root_prim_name):
     """
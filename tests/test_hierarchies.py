@@ -1,4 +1,6 @@
-from pxr import Usd
+from pxr import Gf, Usd
+
+from data import OpticalMarker
 
 
 def test_simple_hierarchy(simple_hierarchy_fbx, root_prim_name):
@@ -8,3 +10,34 @@ def test_simple_hierarchy(simple_hierarchy_fbx, root_prim_name):
     child = nodes[1].name
     assert stage.GetPrimAtPath(f"/{root_prim_name}/{parent}")
     assert stage.GetPrimAtPath(f"/{root_prim_name}/{parent}/{child}")
+
+
+def test_optical_markers_are_batched(optical_markers_fbx, root_prim_name, capfd):
+    file_path, _, nodes = optical_markers_fbx
+    capfd.readouterr()
+    stage = Usd.Stage.Open(file_path)
+    _, err = capfd.readouterr()
+    parent = nodes[0].name
+    marker_nodes = [node for node in nodes if isinstance(node, OpticalMarker)]
+    # A sibling already took the name once sanitized
+    sibling = stage.GetPrimAtPath(f"/{root_prim_name}/{parent}/opticalMarkers")
+    assert sibling and sibling.GetTypeName() != "Points"
+    markers = stage.GetPrimAtPath(f"/{root_prim_name}/{parent}/opticalMarkers_1")
+    assert markers
+    assert markers.GetTypeName() == "Points"
+    for marker in marker_nodes:
+        assert not stage.GetPrimAtPath(f"/{root_prim_name}/{parent}/{marker.name}")
+
+    points = markers.GetAttribute("points").Get()
+    assert len(markers.GetAttribute("ids").Get()) == len(marker_nodes)
+    assert list(markers.GetAttribute("generated:markerNames").Get()) == [marker.name for marker in marker_nodes]
+    # Relative to the parent, which the Points prim inherits its transform from
+    for point, marker in zip(points, marker_nodes):
+        assert Gf.IsClose(point, Gf.Vec3f(*marker.transform.t), 1e-5)
+
+    extent = markers.GetAttribute("extent").Get()
+    assert Gf.IsClose(extent[0], Gf.Vec3f(0.0, 0.0, 0.0), 1e-5)
+    assert Gf.IsClose(extent[1], Gf.Vec3f(2.0, 0.0, 0.0), 1e-5)
+
+    # The children of a marker are dropped with a warning
+    assert "marker0" in err and "not converted" in err
@@ -1,6 +1,14 @@
-from pxr import Usd, Tf, UsdGeom
+import gzip
+import os
+import pathlib
+import shutil
+import subprocess
+import sys
+
+from pxr import Sdf, Usd, Tf, UsdGeom
 import pytest
 from data import TransformableNode, scenebuilder
+from helpers import run_python
 
 
 @pytest.fixture(scope="session")
@@ -98,3 +106,170 @@ def test_multiple_roots(multiple_roots_fbx, root_prim_name):
     assert default_prim.GetName().lower() == root_prim_name.lower()
 
     assert sorted(default_prim.GetChildrenNames()) == sorted([o.name for o in nodes])
+
+
+def test_prewarm_before_first_open(single_null_fbx):
+    # The warm-up happens once per process, and this one may have opened Fbx files already
+    script = """
+import sys, usdFbx
+from pxr import Usd
+assert not usdFbx.WaitForPrewarm(0)
+usdFbx.Prewarm()
+assert usdFbx.WaitForPrewarm(60)
+sys.exit(0 if Usd.Stage.Open(sys.argv[1]) else 1)
+"""
+    assert run_python(script, single_null_fbx[0]) == 0
+
+
+def test_prewarm_on_plugin_load(single_null_fbx):
+    # USDFBX_PREWARM starts the warm-up as soon as importing usdFbx loads the plugin, before any Fbx open
+    script = """
+import sys, usdFbx
+from pxr import Usd
+assert usdFbx.WaitForPrewarm(60)
+sys.exit(0 if Usd.Stage.Open(sys.argv[1]) else 1)
+"""
+    assert run_python(script, single_null_fbx[0], USDFBX_PREWARM="1") == 0
+
+
+def test_load_fbx_disk_cache(single_null_fbx, tmp_path):
+    # USDFBX_CACHE_DIR is read once per process, so both the conversion and the cached open run in a fresh interpreter
+    cache_dir = tmp_path / "cache"
+    script = pathlib.Path(__file__).parent.parent / "tools" / "usdfbx_prewarm.py"
+    result = subprocess.run([sys.executable, str(script), "--cache-dir", str(cache_dir), single_null_fbx[0]])
+    assert result.returncode == 0
+    assert len(list(cache_dir.glob("*.usdc"))) == 1
+
+    script = "import sys; from pxr import Usd; sys.exit(0 if Usd.Stage.Open(sys.argv[1]).GetPrimAtPath('/ROOT/some_null') else 1)"
+    env = dict(os.environ, USDFBX_CACHE_DIR=str(cache_dir))
+    result = subprocess.run([sys.executable, "-c", script, single_null_fbx[0]], env=env)
+    assert result.returncode == 0
+
+
+def test_prewarmed_assets_are_taken(single_null_fbx, root_prim_name, tmp_path):
+    import usdFbx
+
+    # A copy no other test has opened, so that the layer registry cannot serve it
+    file_path = tmp_path / "prewarmed.fbx"
+    shutil.copyfile(single_null_fbx[0], file_path)
+
+    usdFbx.PrewarmAssets([file_path])
+    assert usdFbx.WaitForPrewarmedAssets(60)
+    assert usdFbx.GetPrewarmedAssetCount() == 1
+
+    layer = Sdf.Layer.FindOrOpen(str(file_path))
+    assert layer.GetPrimAtPath(f"/{root_prim_name}/some_null")
+    assert usdFbx.GetPrewarmedAssetCount() == 0
+
+
+def test_prewarmed_assets_are_cleared(single_null_fbx, tmp_path):
+    import usdFbx
+
+    file_path = tmp_path / "cleared.fbx"
+    shutil.copyfile(single_null_fbx[0], file_path)
+
+    usdFbx.PrewarmAssets([file_path], {"precision": "reduced"})
+    assert usdFbx.WaitForPrewarmedAssets(60)
+    assert usdFbx.GetPrewarmedAssetCount() == 1
+    usdFbx.ClearPrewarmedAssets()
+    assert usdFbx.GetPrewarmedAssetCount() == 0
+
+
+def test_prewarmed_assets_expire(single_null_fbx):
+    # USDFBX_PREWARM_EXPIRY is read once per process
+    script = """
+import sys, usdFbx
+usdFbx.PrewarmAssets([sys.argv[1]])
+assert usdFbx.WaitForPrewarmedAssets(60)
+sys.exit(usdFbx.GetPrewarmedAssetCount())
+"""
+    assert run_python(script, single_null_fbx[0], USDFBX_PREWARM_EXPIRY="0") == 0
+
+
+def test_exit_while_prewarming(single_null_fbx, tmp_path):
+    # Conversions still running at exit are cancelled and joined before the Fbx SDK goes away
+    file_paths = [tmp_path / f"exit_{i}.fbx" for i in range(8)]
+    for file_path in file_paths:
+        shutil.copyfile(single_null_fbx[0], file_path)
+    script = """
+import sys, usdFbx
+usdFbx.PrewarmAssets(sys.argv[1:], max_threads=2)
+"""
+    assert run_python(script, *map(str, file_paths)) == 0
+
+
+def test_load_fbx_expired_timeout(single_null_fbx):
+    # A timeout of zero cancels the open before the Fbx SDK gets to import anything
+    with pytest.raises(Tf.ErrorException):
+        _ = Sdf.Layer.FindOrOpen(single_null_fbx[0], {"timeout": "0", "onCancel": "fail"})
+
+
+def test_load_fbx_with_timeout(single_null_fbx, root_prim_name):
+    layer = Sdf.Layer.FindOrOpen(single_null_fbx[0], {"timeout": "600", "onCancel": "partial"})
+    assert layer
+    assert "usdFbx:partial" not in layer.customLayerData
+    assert layer.GetPrimAtPath(f"/{root_prim_name}/some_null")
+
+
+@pytest.mark.parametrize("checkpoints", [1, 2, 3])
+def test_load_fbx_cancelled_partial(basic_plane_fbx, root_prim_name, checkpoints):
+    # USDFBX_CANCEL_AFTER_CHECKPOINTS cancels the conversion before or while the plane is being read.
+    # It only exists in plugins built with USDFBX_BUILD_TESTS
+    script = """
+import sys
+from pxr import Sdf
+layer = Sdf.Layer.FindOrOpen(sys.argv[1], {"onCancel": "partial"})
+if "usdFbx:partial" not in layer.customLayerData:
+    sys.exit(77)
+# The plane keeps its place in the hierarchy, without any of its geometry
+plane = layer.GetPrimAtPath(sys.argv[2])
+assert plane and plane.typeName != "Mesh"
+assert not [name for name in plane.properties.keys() if name == "points" or name.startswith("primvars:")]
+"""
+    plane_path = f"/{root_prim_name}/basic_plane"
+    environment = {"USDFBX_CANCEL_AFTER_CHECKPOINTS": str(checkpoints)}
+    result = run_python(script, basic_plane_fbx[0], plane_path, **environment)
+    if result == 77:
+        pytest.skip("The plugin was built without USDFBX_BUILD_TESTS")
+    assert result == 0
+
+
+def test_cancel_open_without_opens(single_null_fbx):
+    import usdFbx
+
+    assert not usdFbx.CancelOpen(single_null_fbx[0])
+    usdFbx.CancelAllOpens()
+
+
+def compress(extension, data):
+    if extension == "zst":
+        zstandard = pytest.importorskip("zstandard")
+        return zstandard.ZstdCompressor().compress(data)
+    return gzip.compress(data)
+
+
+@pytest.fixture(params=["gz", "zst"])
+def compressed_extension(request, registry):
+    # Only registered by builds configured with USDFBX_REGISTER_COMPRESSED_EXTENSIONS, and zst only with zstd
+    info = registry.GetPluginWithName("usdFbx").metadata
+    if request.param not in info["Types"]["remedy::UsdFbxFileFormat"]["extensions"]:
+        pytest.skip(f"The {request.param} extension is not registered")
+    return request.param
+
+
+def test_load_compressed_fbx(single_null_fbx, root_prim_name, tmp_path, compressed_extension):
+    compressed = tmp_path / f"{pathlib.Path(single_null_fbx[0]).name}.{compressed_extension}"
+    compressed.write_bytes(compress(compressed_extension, pathlib.Path(single_null_fbx[0]).read_bytes()))
+
+    stage = Usd.Stage.Open(str(compressed))
+    assert stage
+    assert stage.GetPrimAtPath(f"/{root_prim_name}/some_null")
+
+
+def test_load_truncated_compressed_fbx(single_null_fbx, tmp_path, compressed_extension):
+    compressed = tmp_path / f"truncated.fbx.{compressed_extension}"
+    data = compress(compressed_extension, pathlib.Path(single_null_fbx[0]).read_bytes())
+    compressed.write_bytes(data[: len(data) // 2])
+
+    with pytest.raises(Tf.ErrorException):
+        _ = Sdf.Layer.FindOrOpen(str(compressed))
@@ -1,5 +1,10 @@
+import collections
+import re
+import shutil
+
 import pytest
-from pxr import Usd, UsdGeom, Vt
+from helpers import run_python
+from pxr import Sdf, Tf, Usd, UsdGeom, Vt
 
 
 def basic_plane_helper(basic_plane_fbx, root_prim_name):
@@ -103,3 +108,153 @@ def test_vertex_colors(basic_plane_fbx, root_prim_name):
     # TODO - Post 1.0: Add additional primvars for color maps like `primvars:color:<NAME>` but warn the user that only the last or first one will be used as the active displaycolor
     color_set = mesh.vertex_colors[-1]
     assert colors == [color_set.coordinates[i] for i in color_set.point_mapping]
+
+
+def assert_ascii_fast_path_matches(mesh_fbx, root_prim_name, registry, capfd):
+    """
+    Binary files ignore the argument, ASCII files must convert to exactly the same data either way.
+    Returns whether the fast path parsed the file.
+    """
+    mesh_file_path, _, nodes = mesh_fbx
+    mesh_path = f"/{root_prim_name}/{nodes[0].name}"
+    registry.GetPluginWithName("usdFbx").Load()
+
+    # Anonymous layers are never shared with the layer registry, every open reads the file again
+    def open_layer(fast_path):
+        return Sdf.Layer.OpenAsAnonymous(Sdf.Layer.CreateIdentifier(mesh_file_path, {"asciiFastPath": fast_path}))
+
+    reference = open_layer("0")
+    capfd.readouterr()
+    Tf.Debug.SetDebugSymbolsByName("USDFBX", 1)
+    try:
+        fast = open_layer("1")
+    finally:
+        Tf.Debug.SetDebugSymbolsByName("USDFBX", 0)
+    out, _ = capfd.readouterr()
+
+    reference_attributes = reference.GetPrimAtPath(mesh_path).attributes
+    fast_attributes = fast.GetPrimAtPath(mesh_path).attributes
+    assert sorted(reference_attributes.keys()) == sorted(fast_attributes.keys())
+    for name, attribute in reference_attributes.items():
+        assert fast_attributes[name].default == attribute.default, name
+    return "ahead of the import" in out
+
+
+def test_ascii_fast_path(basic_plane_fbx, root_prim_name, registry, capfd):
+    # The plane is mostly made of the file header, it is left to the Fbx SDK
+    assert not assert_ascii_fast_path_matches(basic_plane_fbx, root_prim_name, registry, capfd)
+
+
+def test_ascii_fast_path_large_mesh(large_grid_fbx, root_prim_name, registry, capfd):
+    parsed = assert_ascii_fast_path_matches(large_grid_fbx, root_prim_name, registry, capfd)
+    assert parsed == ("ascii" in large_grid_fbx[1].file_format)
+
+
+def test_ascii_fast_path_by_edge_smoothing(smoothed_grid_fbx, root_prim_name, registry, capfd):
+    # The by-edge smoothing follows the edges of the file, which the fast path keeps in their order
+    parsed = assert_ascii_fast_path_matches(smoothed_grid_fbx, root_prim_name, registry, capfd)
+    assert parsed == ("ascii" in smoothed_grid_fbx[1].file_format)
+
+
+def test_reduced_precision(basic_plane_fbx, root_prim_name):
+    mesh_file_path, _, nodes = basic_plane_fbx
+    mesh_path = f"/{root_prim_name}/{nodes[0].name}"
+    full = Sdf.Layer.FindOrOpen(mesh_file_path)
+    reduced = Sdf.Layer.FindOrOpen(mesh_file_path, {"precision": "reduced"})
+
+    full_attributes = full.GetPrimAtPath(mesh_path).attributes
+    reduced_attributes = reduced.GetPrimAtPath(mesh_path).attributes
+    assert reduced_attributes["points"].typeName == Sdf.ValueTypeNames.Point3fArray
+    assert reduced_attributes["points"].default == full_attributes["points"].default
+    assert reduced_attributes["normals"].typeName == Sdf.ValueTypeNames.Normal3hArray
+    for reduced_normal, full_normal in zip(reduced_attributes["normals"].default, full_attributes["normals"].default):
+        assert all(abs(a - b) < 1e-3 for a, b in zip(reduced_normal, full_normal))
+
+    translate = reduced.GetPrimAtPath(mesh_path).attributes["xformOp:translate"]
+    assert translate.typeName == Sdf.ValueTypeNames.Float3
+
+
+def test_shared_arrays_outlive_layers(large_grid_fbx, root_prim_name, tmp_path, capfd):
+    # Identical files share their arrays, which must stay intact once both layers are released.
+    # Sharing is opt-in and environment settings are read once per process
+    mesh_file_path, _, nodes = large_grid_fbx
+    copies = [tmp_path / f"copy{i}.fbx" for i in range(2)]
+    for copy in copies:
+        shutil.copyfile(mesh_file_path, copy)
+
+    script = """
+import sys
+from pxr import Sdf
+names = ("points", "faceVertexIndices", "normals")
+layers = [Sdf.Layer.FindOrOpen(path) for path in sys.argv[2:]]
+arrays = [[layer.GetPrimAtPath(sys.argv[1]).attributes[name].default for name in names] for layer in layers]
+expected = [list(array) for array in arrays[0]]
+# The points alone are well above the 16KiB below which arrays are not shared
+assert len(expected[0]) * 12 > 16 * 1024
+del layers
+sys.exit(0 if all(list(array) == values for copy in arrays for array, values in zip(copy, expected)) else 1)
+"""
+    mesh_path = f"/{root_prim_name}/{nodes[0].name}"
+    capfd.readouterr()
+    assert run_python(script, mesh_path, *map(str, copies), USDFBX_SHARE_ARRAYS="1", TF_DEBUG="USDFBX") == 0
+    out, _ = capfd.readouterr()
+
+    # The second layer finds every one of its large arrays in the store, which does not grow
+    shared = [int(count) for count in re.findall(r"(\d+) arrays are shared between the open Fbx layers", out)]
+    assert len(shared) == 2
+    assert shared[0] >= len(("points", "faceVertexIndices", "normals"))
+    assert shared[1] == shared[0]
+
+
+def test_clean_meshes(degenerate_plane_fbx, root_prim_name):
+    mesh_file_path, _, nodes = degenerate_plane_fbx
+    mesh_path = f"/{root_prim_name}/{nodes[0].name}"
+    original = Sdf.Layer.FindOrOpen(mesh_file_path).GetPrimAtPath(mesh_path).attributes
+    assert len(original["faceVertexCounts"].default) == 4
+    assert len(original["points"].default) == 6
+
+    cleaned = Sdf.Layer.FindOrOpen(mesh_file_path, {"cleanMeshes": "1"}).GetPrimAtPath(mesh_path).attributes
+    assert list(cleaned["faceVertexCounts"].default) == [3, 3]
+    assert list(cleaned["faceVertexIndices"].default) == list(original["faceVertexIndices"].default[:6])
+    assert list(cleaned["points"].default) == list(original["points"].default[:4])
+    assert len(cleaned["normals"].default) == 6
+    assert list(cleaned["primvars:st"].default) == list(original["primvars:st"].default[:6])
+
+
+def test_optimize_vertex_cache(triangle_grid_fbx, root_prim_name):
+    mesh_file_path, _, nodes = triangle_grid_fbx
+    mesh_path = f"/{root_prim_name}/{nodes[0].name}"
+    original = Sdf.Layer.FindOrOpen(mesh_file_path).GetPrimAtPath(mesh_path).attributes
+    optimized = Sdf.Layer.FindOrOpen(mesh_file_path, {"optimizeVertexCache": "1"}).GetPrimAtPath(mesh_path).attributes
+
+    def acmr(attributes, cache_size=32):
+        # Average cache miss ratio: vertices transformed per triangle through a FIFO post-transform cache
+        indices = attributes["faceVertexIndices"].default
+        cache = collections.deque(maxlen=cache_size)
+        misses = 0
+        for index in indices:
+            if index not in cache:
+                misses += 1
+                cache.append(index)
+        return misses / (len(indices) // 3)
+
+    def triangles(attributes):
+        points = attributes["points"].default
+        indices = attributes["faceVertexIndices"].default
+        uvs = attributes["primvars:st_set_a"].default
+        normals = attributes["normals"].default
+
+        def corner(i):
+            return tuple(points[indices[i]]), tuple(uvs[i]), tuple(normals[i])
+
+        return sorted(tuple(corner(i + offset) for offset in range(3)) for i in range(0, len(indices), 3))
+
+    # Same surface: the same triangles, with the same winding and face varying data, only their order changes
+    assert list(optimized["faceVertexCounts"].default) == list(original["faceVertexCounts"].default)
+    assert sorted(map(tuple, optimized["points"].default)) == sorted(map(tuple, original["points"].default))
+    assert triangles(optimized) == triangles(original)
+    # Points are stored in the order the triangles first use them
+    assert list(optimized["faceVertexIndices"].default[:3]) == [0, 1, 2]
+
+    # Every row is longer than the cache, drawn in order nearly every triangle misses once
+    assert acmr(optimized) < 0.9 * acmr(original)
@@ -6,6 +6,7 @@ from data import (
     Joint,
     MappedCoordinates,
     Mesh,
+    OpticalMarker,
     SkinBinding,
     TransformableNode,
     scenebuilder,
@@ -148,6 +149,28 @@ def test_nested_skeleton(nested_skeletons_fbx, root_prim_name):
     assert parent and not parent.IsA(UsdSkel.Skeleton)
 
 
+@pytest.fixture
+def skeleton_markers_fbx(fbx_defaults):
+    output_dir, manager, scene, fbx_file_format = fbx_defaults
+    with scenebuilder.SceneBuilder(manager, scene, output_dir) as builder:
+        builder.settings.file_format = fbx_file_format
+        root_node = Joint(name="root", is_root=True)
+        child_1 = Joint(name="child_1", parent=root_node, transform=Transform(t=(1.0, 0.0, 0.0)))
+        markers = [OpticalMarker(f"marker{i}", parent=joint) for i, joint in enumerate((root_node, child_1))]
+        builder.nodes.extend([root_node, child_1, *markers])
+    yield str(builder.settings.file_path), builder.nodes
+
+
+def test_skeleton_optical_markers_warn(skeleton_markers_fbx, root_prim_name, capfd):
+    # The skeleton readers only convert joints, the markers below them are reported rather than silently dropped
+    file_path, nodes = skeleton_markers_fbx
+    capfd.readouterr()
+    stage = Usd.Stage.Open(file_path)
+    _, err = capfd.readouterr()
+    assert UsdSkel.Skeleton.Get(stage, f"/{root_prim_name}/root")
+    assert '2 optical markers under skeleton "root" are not converted' in err
+
+
 @pytest.fixture
 def mixed_type_hierarchy_fbx(fbx_defaults):
     output_dir, manager, scene, fbx_file_format = fbx_defaults
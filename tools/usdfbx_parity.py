@@ -0,0 +1,233 @@
+#!/usr/bin/env python
+"""
+Compares the query performance of an Fbx layer with the one of the same layer converted to usdc.
+
+A synthetic Fbx file (animated nulls and a skinned grid on an animated joint chain) is generated and
+converted to usdc once, then the same workloads run against both files: stage open, full prim traversal,
+attribute reads at the default time and at every time sample, and xform and skeleton playback through
+UsdGeom.XformCache and UsdSkel.Cache. The best time of each workload is reported along with the Fbx/usdc
+ratio.
+
+Requires the Fbx Python SDK and the tests directory of this repository, which holds the scene builder.
+
+Example:
+    python usdfbx_parity.py --nulls 500 --grid 64 --joints 16 --frames 120 --repeat 5
+    python usdfbx_parity.py --ascii --grid 256 --arg asciiFastPath=1
+"""
+import argparse
+import os
+import pathlib
+import sys
+import tempfile
+import time
+
+TESTS_DIR = pathlib.Path(__file__).resolve().parent.parent / "tests"
+
+
+def parse_args(argv):
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--nulls", type=int, default=200, help="Number of animated nulls")
+    parser.add_argument("--grid", type=int, default=32, help="Number of quads along each side of the skinned grid")
+    parser.add_argument("--joints", type=int, default=8, help="Number of joints in the animated chain")
+    parser.add_argument("--frames", type=int, default=48, help="Number of animated frames")
+    parser.add_argument("--ascii", action="store_true", help="Write the Fbx file as ASCII instead of binary")
+    parser.add_argument("--repeat", type=int, default=3, help="Number of runs of each workload, the best one is kept")
+    parser.add_argument(
+        "--output-dir",
+        type=pathlib.Path,
+        help="Directory for the generated Fbx and usdc files, defaults to a temporary directory",
+    )
+    parser.add_argument(
+        "--arg",
+        action="append",
+        default=[],
+        metavar="KEY=VALUE",
+        help="File format argument used when opening the Fbx layer, may be repeated",
+    )
+    parser.add_argument(
+        "--max-ratio",
+        type=float,
+        help="Fail when the Fbx/usdc ratio of any workload other than stage open is above this value",
+    )
+    return parser.parse_args(argv)
+
+
+def generate_fbx(output_dir, args):
+    import FbxCommon as fbx
+    from data import AnimationCurve, Joint, Mesh, Property, SkinBinding, Transform, TransformableNode, scenebuilder
+    from helpers import create_FbxTime
+
+    def animated_property(name, values):
+        curve = AnimationCurve(
+            anim_layer="Base",
+            times=[create_FbxTime(frame) for frame in range(len(values))],
+            values=[fbx.FbxDouble3(*value) for value in values],
+        )
+        return Property(name=name, animation_curves=[curve], value=fbx.FbxDouble3(*values[0]))
+
+    frames = range(args.frames + 1)
+    manager, scene = fbx.InitializeSdkObjects()
+    with scenebuilder.SceneBuilder(manager, scene, output_dir) as builder:
+        builder.settings.anim_layers = ("Base",)
+        if args.ascii:
+            builder.settings.file_format = "FBX ascii (*.fbx)"
+
+        for i in range(args.nulls):
+            translation = animated_property("LclTranslation", [(i, frame * 0.5, 0.0) for frame in frames])
+            rotation = animated_property("LclRotation", [(0.0, (frame * 3 + i) % 360, 0.0) for frame in frames])
+            builder.nodes.append(TransformableNode(f"null{i}", properties=[translation, rotation]))
+
+        joint_length = 10.0
+        joints = []
+        for i in range(args.joints):
+            rotation = animated_property("LclRotation", [(0.0, 0.0, 20.0 * (frame % 12) / 12) for frame in frames])
+            joints.append(
+                Joint(
+                    name=f"joint{i}",
+                    parent=joints[-1] if joints else None,
+                    is_root=not joints,
+                    transform=Transform(t=(joint_length if joints else 0.0, 0.0, 0.0)),
+                    properties=[rotation],
+                )
+            )
+        builder.nodes.extend(joints)
+
+        # Every column of points follows the joint closest to it
+        side = args.grid + 1
+        length = joint_length * args.joints
+        points = [(length * x / args.grid, 0.0, length * z / args.grid) for z in range(side) for x in range(side)]
+        polygons = [
+            (z * side + x, (z + 1) * side + x, (z + 1) * side + x + 1, z * side + x + 1)
+            for z in range(args.grid)
+            for x in range(args.grid)
+        ]
+        weights = [[] for _ in joints]
+        for index, point in enumerate(points):
+            weights[min(int(point[0] / joint_length), len(joints) - 1)].append((index, 1.0))
+        bindings = tuple(
+            SkinBinding(target_joint=joint, vertex_weights=tuple(joint_weights))
+            for joint, joint_weights in zip(joints, weights)
+            if joint_weights
+        )
+        builder.nodes.append(Mesh(name="skinned_grid", points=points, polygons=polygons, skinbinding=bindings))
+    manager.Destroy()
+    return builder.settings.file_path
+
+
+def run_workloads(file_path, format_args):
+    from pxr import Sdf, Usd, UsdGeom, UsdSkel
+
+    # Anonymous layers are never shared with the layer registry, every open reads the file again
+    identifier = Sdf.Layer.CreateIdentifier(str(file_path), format_args)
+
+    def open_stage():
+        return Usd.Stage.Open(Sdf.Layer.OpenAsAnonymous(identifier))
+
+    stage = open_stage()
+    prims = list(Usd.PrimRange(stage.GetPseudoRoot()))
+    attributes = [attribute for prim in prims for attribute in prim.GetAttributes()]
+    start, end = stage.GetStartTimeCode(), stage.GetEndTimeCode()
+    times = [Usd.TimeCode(frame) for frame in range(int(start), int(end) + 1)]
+    xformables = [UsdGeom.Xformable(prim) for prim in prims if prim.IsA(UsdGeom.Xformable)]
+    skel_roots = [UsdSkel.Root(prim) for prim in prims if prim.IsA(UsdSkel.Root)]
+
+    def traverse():
+        return sum(1 for _ in Usd.PrimRange(stage.GetPseudoRoot()))
+
+    def get_default():
+        for attribute in attributes:
+            attribute.Get()
+
+    def get_samples():
+        for attribute in attributes:
+            for sample in attribute.GetTimeSamples():
+                attribute.Get(sample)
+
+    def xform_playback():
+        cache = UsdGeom.XformCache()
+        for t in times:
+            cache.SetTime(t)
+            for xformable in xformables:
+                cache.GetLocalToWorldTransform(xformable.GetPrim())
+
+    def skel_playback():
+        cache = UsdSkel.Cache()
+        for skel_root in skel_roots:
+            try:
+                cache.Populate(skel_root, Usd.PrimDefaultPredicate)
+            except TypeError:
+                # Releases before 23.02 have no predicate argument
+                cache.Populate(skel_root)
+            for binding in cache.ComputeSkelBindings(skel_root, Usd.PrimDefaultPredicate):
+                query = cache.GetSkelQuery(binding.GetSkeleton())
+                for t in times:
+                    query.ComputeJointLocalTransforms(t)
+                    query.ComputeSkinningTransforms(t)
+
+    workloads = {
+        "open": open_stage,
+        "traverse": traverse,
+        "get_default": get_default,
+        "get_samples": get_samples,
+        "xform_playback": xform_playback,
+        "skel_playback": skel_playback,
+    }
+    return stage, workloads
+
+
+def best_time(workload, repeat):
+    best = float("inf")
+    for _ in range(repeat):
+        start = time.perf_counter()
+        result = workload()
+        best = min(best, time.perf_counter() - start)
+        del result
+    return best
+
+
+def main(argv=None):
+    args = parse_args(argv)
+
+    # The on-disk cache would turn every Fbx open after the first into a usdc open.
+    # Environment settings are read once by USD, so this has to happen before pxr is imported
+    os.environ.pop("USDFBX_CACHE_DIR", None)
+    sys.path.insert(0, str(TESTS_DIR))
+    from pxr import Sdf
+
+    format_args = dict(arg.split("=", 1) for arg in args.arg)
+    with tempfile.TemporaryDirectory() as temp_dir:
+        output_dir = args.output_dir or pathlib.Path(temp_dir)
+        output_dir.mkdir(parents=True, exist_ok=True)
+
+        fbx_path = generate_fbx(output_dir, args)
+        usdc_path = fbx_path.with_suffix(".usdc")
+        layer = Sdf.Layer.FindOrOpen(str(fbx_path), format_args)
+        if layer is None or not layer.Export(str(usdc_path)):
+            print(f"Failed to convert {fbx_path} to usdc", file=sys.stderr)
+            return 1
+        del layer
+
+        timings = {}
+        for name, path, path_args in (("fbx", fbx_path, format_args), ("usdc", usdc_path, {})):
+            stage, workloads = run_workloads(path, path_args)
+            timings[name] = {workload: best_time(fn, max(1, args.repeat)) for workload, fn in workloads.items()}
+            del stage, workloads
+
+    print(f"{'workload':<16}{'fbx ms':>12}{'usdc ms':>12}{'ratio':>10}")
+    failures = []
+    for workload, fbx_time in timings["fbx"].items():
+        usdc_time = timings["usdc"][workload]
+        ratio = fbx_time / usdc_time if usdc_time > 0 else float("inf")
+        print(f"{workload:<16}{fbx_time * 1000:>12.3f}{usdc_time * 1000:>12.3f}{ratio:>10.2f}")
+        # Opening an Fbx file includes its conversion, it is reported but not held to the limit
+        if args.max_ratio is not None and workload != "open" and ratio > args.max_ratio:
+            failures.append(workload)
+
+    if failures:
+        print(f"Above the {args.max_ratio} ratio: {', '.join(failures)}", file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
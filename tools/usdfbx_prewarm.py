@@ -0,0 +1,85 @@
+#!/usr/bin/env python
+"""
+Converts a list of Fbx files into the usdFbx on-disk cache ahead of time.
+
+Layers opened later by any process with the same USDFBX_CACHE_DIR are read from the cached usdc files
+instead of going through the Fbx SDK.
+
+The Fbx SDK is not thread safe and imports one file at a time, whatever the number of threads. More threads
+only overlap the file reads, the parsing of ASCII geometry and the usdc writes with the imports.
+
+Example:
+    python usdfbx_prewarm.py --cache-dir /tmp/usdfbx_cache --threads 8 shot_010/*.fbx
+"""
+import argparse
+import concurrent.futures
+import os
+import pathlib
+import sys
+
+
+def parse_args(argv):
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("files", nargs="*", type=pathlib.Path, help="Fbx files to convert")
+    parser.add_argument(
+        "--file-list",
+        type=pathlib.Path,
+        help="Text file with one Fbx path per line, in addition to the positional files",
+    )
+    parser.add_argument(
+        "--cache-dir",
+        default=os.environ.get("USDFBX_CACHE_DIR", ""),
+        help="Cache directory, defaults to $USDFBX_CACHE_DIR",
+    )
+    parser.add_argument(
+        "--threads",
+        type=int,
+        default=os.cpu_count(),
+        help="Maximum number of files opened at once, their Fbx SDK imports still run one at a time",
+    )
+    parser.add_argument(
+        "--arg",
+        action="append",
+        default=[],
+        metavar="KEY=VALUE",
+        help="File format argument used when opening the layers, may be repeated",
+    )
+    return parser.parse_args(argv)
+
+
+def main(argv=None):
+    args = parse_args(argv)
+    if not args.cache_dir:
+        print("No cache directory given, use --cache-dir or set USDFBX_CACHE_DIR", file=sys.stderr)
+        return 1
+
+    files = list(args.files)
+    if args.file_list:
+        files += [pathlib.Path(line.strip()) for line in args.file_list.read_text().splitlines() if line.strip()]
+    if not files:
+        print("No Fbx files given", file=sys.stderr)
+        return 1
+
+    # Environment settings are read once by USD, so this has to be set before pxr is imported
+    os.environ["USDFBX_CACHE_DIR"] = str(pathlib.Path(args.cache_dir).resolve())
+    from pxr import Sdf
+
+    format_args = dict(arg.split("=", 1) for arg in args.arg)
+
+    def convert(file_path):
+        # The plugin writes the cache in the background once the layer is read, and waits for it at exit
+        return Sdf.Layer.FindOrOpen(str(file_path.resolve()), format_args) is not None
+
+    failures = 0
+    with concurrent.futures.ThreadPoolExecutor(max_workers=max(1, args.threads)) as executor:
+        for file_path, success in zip(files, executor.map(convert, files)):
+            if not success:
+                failures += 1
+                print(f"Failed to convert {file_path}", file=sys.stderr)
+
+    print(f"Converted {len(files) - failures}/{len(files)} Fbx files into {os.environ['USDFBX_CACHE_DIR']}")
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())